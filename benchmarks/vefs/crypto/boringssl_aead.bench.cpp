@@ -0,0 +1,88 @@
+#include "vefs/crypto/boringssl_aead.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <vefs/crypto/provider.hpp>
+
+#include "vefs/crypto/crypto_provider_boringssl.hpp"
+
+namespace
+{
+
+using vefs::crypto::detail::boringssl_aead;
+using vefs::crypto::detail::boringssl_aes_256_gcm_provider;
+
+constexpr std::size_t sector_payload_size = (1 << 15) - (1 << 5);
+
+using key_material
+        = std::array<std::byte,
+                     boringssl_aes_256_gcm_provider::key_material_size>;
+
+auto make_key_material(std::size_t i) noexcept -> key_material
+{
+    key_material keyMaterial{};
+    for (std::size_t j = 0; j < keyMaterial.size(); ++j)
+    {
+        keyMaterial[j] = static_cast<std::byte>(i + j * 31U);
+    }
+    return keyMaterial;
+}
+
+// the per sector setup cost if every box operation creates a new context
+void aead_create(benchmark::State &state)
+{
+    auto const keyMaterial = make_key_material(0U);
+
+    for (auto _ : state)
+    {
+        auto aead = boringssl_aead::create(
+                std::span(keyMaterial).first<32>());
+        benchmark::DoNotOptimize(aead);
+    }
+}
+BENCHMARK(aead_create);
+
+// the per sector setup cost if a context is reused
+void aead_rekey(benchmark::State &state)
+{
+    auto const keyMaterial = make_key_material(0U);
+    boringssl_aead aead;
+
+    for (auto _ : state)
+    {
+        auto rekeyRx = aead.rekey(std::span(keyMaterial).first<32>());
+        benchmark::DoNotOptimize(rekeyRx);
+        aead.reset();
+    }
+}
+BENCHMARK(aead_rekey);
+
+// a complete sector seal including the setup, i.e. the baseline for the
+// setup cost measured above
+void box_seal_sector(benchmark::State &state)
+{
+    auto *const provider
+            = vefs::crypto::boringssl_aes_256_gcm_crypto_provider();
+    auto const keyMaterial = make_key_material(0U);
+    std::vector<std::byte> plaintext(sector_payload_size);
+    std::vector<std::byte> ciphertext(sector_payload_size);
+    std::array<std::byte, 16> mac{};
+
+    for (auto _ : state)
+    {
+        auto sealRx
+                = provider->box_seal(ciphertext, mac, keyMaterial, plaintext);
+        benchmark::DoNotOptimize(sealRx);
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations())
+                            * static_cast<std::int64_t>(sector_payload_size));
+}
+BENCHMARK(box_seal_sector);
+
+} // namespace
@@ -0,0 +1,151 @@
+#include "vefs/detail/file_crypto_ctx.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include <vefs/archive_fwd.hpp>
+#include <vefs/crypto/provider.hpp>
+
+#include "libb2_none_blake2b_crypto_provider.hpp"
+
+namespace
+{
+
+using vefs::detail::file_crypto_ctx;
+
+using provider_factory = vefs::crypto::crypto_provider *(*)();
+
+constexpr std::size_t sector_size = 1 << 15;
+constexpr std::size_t sector_payload_size = sector_size - (1 << 5);
+
+constexpr std::array<std::byte, 16> session_salt{};
+
+int const max_threads
+        = static_cast<int>(std::max(1U, std::thread::hardware_concurrency()));
+
+// all threads of a benchmark share a single context, just like the workers
+// accessing the sectors of a single file
+auto shared_file_ctx() -> file_crypto_ctx &
+{
+    static file_crypto_ctx ctx(file_crypto_ctx::zero_init);
+    return ctx;
+}
+
+struct sector_buffers
+{
+    std::vector<std::byte> plaintext;
+    std::vector<std::byte> ciphertext;
+    std::array<std::byte, 16> mac{};
+
+    sector_buffers()
+        : plaintext(sector_payload_size)
+        , ciphertext(sector_size)
+    {
+        for (std::size_t i = 0; i < plaintext.size(); ++i)
+        {
+            plaintext[i] = static_cast<std::byte>(i * 31U);
+        }
+    }
+
+    auto plain() noexcept -> vefs::rw_blob<sector_payload_size>
+    {
+        return vefs::rw_blob<sector_payload_size>(plaintext.data(),
+                                                  sector_payload_size);
+    }
+    auto cipher() noexcept -> vefs::rw_blob<sector_size>
+    {
+        return vefs::rw_blob<sector_size>(ciphertext.data(), sector_size);
+    }
+};
+
+void set_sector_throughput(benchmark::State &state)
+{
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations())
+                            * static_cast<std::int64_t>(sector_payload_size));
+}
+
+// key derivation + AEAD of a single sector
+void seal_sector(benchmark::State &state, provider_factory makeProvider)
+{
+    auto &provider = *makeProvider();
+    auto &ctx = shared_file_ctx();
+    sector_buffers buffers;
+
+    for (auto _ : state)
+    {
+        if (ctx.seal_sector(buffers.cipher(), buffers.mac, provider,
+                            session_salt, buffers.plain())
+                    .has_error())
+        {
+            state.SkipWithError("seal_sector() failed");
+            break;
+        }
+        benchmark::ClobberMemory();
+    }
+    set_sector_throughput(state);
+}
+
+void unseal_sector(benchmark::State &state, provider_factory makeProvider)
+{
+    auto &provider = *makeProvider();
+    auto &ctx = shared_file_ctx();
+    sector_buffers buffers;
+    if (ctx.seal_sector(buffers.cipher(), buffers.mac, provider, session_salt,
+                        buffers.plain())
+                .has_error())
+    {
+        state.SkipWithError("seal_sector() failed");
+        return;
+    }
+
+    for (auto _ : state)
+    {
+        if (ctx.unseal_sector(buffers.plain(), provider, buffers.cipher(),
+                              buffers.mac)
+                    .has_error())
+        {
+            state.SkipWithError("unseal_sector() failed");
+            break;
+        }
+        benchmark::ClobberMemory();
+    }
+    set_sector_throughput(state);
+}
+
+BENCHMARK_CAPTURE(seal_sector,
+                  aes_256_gcm,
+                  &vefs::crypto::boringssl_aes_256_gcm_crypto_provider)
+        ->ThreadRange(1, max_threads)
+        ->UseRealTime();
+BENCHMARK_CAPTURE(seal_sector,
+                  chacha20_poly1305,
+                  &vefs::crypto::boringssl_chacha20_poly1305_crypto_provider)
+        ->ThreadRange(1, max_threads)
+        ->UseRealTime();
+BENCHMARK_CAPTURE(seal_sector, only_mac, &vefs::test::only_mac_crypto_provider)
+        ->ThreadRange(1, max_threads)
+        ->UseRealTime();
+
+BENCHMARK_CAPTURE(unseal_sector,
+                  aes_256_gcm,
+                  &vefs::crypto::boringssl_aes_256_gcm_crypto_provider)
+        ->ThreadRange(1, max_threads)
+        ->UseRealTime();
+BENCHMARK_CAPTURE(unseal_sector,
+                  chacha20_poly1305,
+                  &vefs::crypto::boringssl_chacha20_poly1305_crypto_provider)
+        ->ThreadRange(1, max_threads)
+        ->UseRealTime();
+BENCHMARK_CAPTURE(unseal_sector,
+                  only_mac,
+                  &vefs::test::only_mac_crypto_provider)
+        ->ThreadRange(1, max_threads)
+        ->UseRealTime();
+
+} // namespace
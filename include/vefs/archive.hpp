@@ -1,13 +1,19 @@
 #pragma once
 
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <optional>
 #include <span>
 #include <string_view>
 #include <tuple>
 
 #include <vefs/archive_fwd.hpp>
+#include <vefs/cache_policy.hpp>
+#include <vefs/cache_stats.hpp>
 #include <vefs/disappointment.hpp>
+#include <vefs/io_engine.hpp>
 #include <vefs/llfio.hpp>
 #include <vefs/span.hpp>
 #include <vefs/utils/enum_bitset.hpp>
@@ -53,6 +59,85 @@ enum class backup_mode
 std::true_type allow_enum_bitset(file_open_mode &&);
 using file_open_mode_bitset = enum_bitset<file_open_mode>;
 
+/**
+ * @brief The archive_options::cache_numa_node value which spreads the shards
+ * of the shared sector cache round robin over all NUMA nodes.
+ */
+inline constexpr int cache_numa_interleave = -2;
+
+/**
+ * @brief Options which are applied while opening or creating an archive.
+ */
+struct archive_options
+{
+    /**
+     * @brief The cache_budget which is assumed if none is given explicitly.
+     */
+    static constexpr std::size_t default_cache_budget = std::size_t{1} << 30;
+
+    io_engine engine = io_engine::synchronous;
+    /**
+     * @brief The number of bytes the sector caches of all open vfiles may
+     * occupy in total.
+     *
+     * Each vfile cache is sized after the file it belongs to, but never
+     * smaller than min_file_cache_size, i.e. a new vfile starts with that
+     * minimum and opening a vfile fails with errc::not_enough_memory once
+     * the remaining budget can't accommodate it. A vfile cache is resized
+     * whenever the vfile is reopened.
+     *
+     * Without an explicit budget default_cache_budget is distributed among
+     * the vfiles, but opening a vfile never fails for lack of budget; such
+     * vfiles are granted min_file_cache_size instead.
+     */
+    std::optional<std::size_t> cache_budget = std::nullopt;
+    /**
+     * @brief The minimum size of a single vfile sector cache in bytes.
+     */
+    std::size_t min_file_cache_size = std::size_t{4} << 20;
+    /**
+     * @brief Whether the archive index and all vfiles share a single sector
+     * cache of cache_budget (or default_cache_budget) bytes.
+     *
+     * The shared cache decides admission across all files, i.e. frequently
+     * accessed files may claim the pages of idle ones. Note that its memory
+     * is reserved upfront.
+     */
+    bool shared_sector_cache = false;
+    /**
+     * @brief The eviction policy of every sector cache of the archive.
+     *
+     * Defaults to LRU which the sector caches always used before the policy
+     * became selectable.
+     */
+    cache_policy eviction_policy = cache_policy::least_recently_used;
+    /**
+     * @brief Whether the pages of the shared sector cache are backed by huge
+     * pages which reduces the TLB misses of large caches.
+     *
+     * Explicit huge pages are preferred over transparent ones. Regular pages
+     * are used if the system provides neither.
+     */
+    bool huge_page_cache = false;
+    /**
+     * @brief The NUMA node on which the pages of the shared sector cache are
+     * preferably placed.
+     *
+     * A negative value leaves the placement to the system, see also
+     * cache_numa_interleave.
+     */
+    int cache_numa_node = -1;
+    /**
+     * @brief Whether free sectors are discarded, i.e. whether their storage
+     * is returned to the host file system by punching holes into the archive
+     * file.
+     *
+     * Erased sectors are discarded as a whole instead of being overwritten.
+     * If the file system can't punch holes, zeros are written instead.
+     */
+    bool discard_free_sectors = false;
+};
+
 struct file_query_result
 {
     file_open_mode_bitset allowed_flags;
@@ -138,16 +223,20 @@ public:
      *
      * @param file the LLFIO file handle to the encrypted archive file
      * @param userPRK the key used to decrypt and encrypt the archive
-     * @param cryptoProvider provides the underyling cryptographic procedures
+     * @param cryptoProvider provides the underyling cryptographic procedures;
+     *        existing archives keep using the algorithm recorded in their
+     *        header if a builtin provider is given
      * @param creationMode creation in regards to the file
+     * @param options tuning options applied to the opened archive
      * @return the archive or errors that occured while creating the archive
      *         handle
      */
     static auto archive(llfio::file_handle const &file,
                         ro_blob<32> userPRK,
                         crypto::crypto_provider *cryptoProvider
-                        = crypto::boringssl_aes_256_gcm_crypto_provider(),
-                        creation creationMode = creation::open_existing)
+                        = crypto::boringssl_preferred_crypto_provider(),
+                        creation creationMode = creation::open_existing,
+                        archive_options const &options = {})
             -> result<archive_handle>;
     /**
      * @brief Create an archive from an LLFIO path handle and file.
@@ -157,6 +246,7 @@ public:
      * userPRK the key used to decrypt and encrypt the archive
      * @param cryptoProvider provides the underyling cryptographic procedures
      * @param creationMode creation in regards to the file
+     * @param options tuning options applied to the opened archive
      * @return the archive or errors that occured while creating the archive
      *         handle
      */
@@ -164,8 +254,9 @@ public:
                         llfio::path_view path,
                         storage_key_type userPRK,
                         crypto::crypto_provider *cryptoProvider
-                        = crypto::boringssl_aes_256_gcm_crypto_provider(),
-                        creation creationMode = creation::open_existing)
+                        = crypto::boringssl_preferred_crypto_provider(),
+                        creation creationMode = creation::open_existing,
+                        archive_options const &options = {})
             -> result<archive_handle>;
 
     /**
@@ -338,6 +429,12 @@ public:
      */
     auto list_files() -> std::vector<std::string>;
 
+    /**
+     * @brief Takes a snapshot of the statistics of the sector caches which
+     * belong to the archive index and the currently open virtual files.
+     */
+    auto cache_stats() -> vefs::cache_stats;
+
     /**
      * Extracts a vfile at the given path as a physical file on the
      * device in the given path.
@@ -378,11 +475,13 @@ private:
 
     static auto open_existing(llfio::file_handle mfh,
                               crypto::crypto_provider *cryptoProvider,
-                              storage_key_type userPRK) noexcept
+                              storage_key_type userPRK,
+                              archive_options const &options) noexcept
             -> result<archive_handle>;
     static auto create_new(llfio::file_handle mfh,
                            crypto::crypto_provider *cryptoProvider,
-                           storage_key_type userPRK) noexcept
+                           storage_key_type userPRK,
+                           archive_options const &options) noexcept
             -> result<archive_handle>;
 
     static auto purge_corruption(llfio::file_handle &&file,
@@ -399,21 +498,24 @@ inline auto vefs::archive_handle::ops_pool() -> detail::pooled_work_tracker &
 inline auto archive(llfio::file_handle const &file,
                     ro_blob<32> userPRK,
                     crypto::crypto_provider *cryptoProvider
-                    = crypto::boringssl_aes_256_gcm_crypto_provider(),
-                    creation creationMode = creation::open_existing)
+                    = crypto::boringssl_preferred_crypto_provider(),
+                    creation creationMode = creation::open_existing,
+                    archive_options const &options = {})
 {
-    return archive_handle::archive(file, userPRK, cryptoProvider, creationMode);
+    return archive_handle::archive(file, userPRK, cryptoProvider, creationMode,
+                                   options);
 }
 inline auto archive(llfio::path_handle const &base,
                     llfio::path_view path,
                     archive_handle::storage_key_type userPRK,
                     crypto::crypto_provider *cryptoProvider
-                    = crypto::boringssl_aes_256_gcm_crypto_provider(),
-                    creation creationMode = creation::open_existing)
+                    = crypto::boringssl_preferred_crypto_provider(),
+                    creation creationMode = creation::open_existing,
+                    archive_options const &options = {})
         -> result<archive_handle>
 {
     return archive_handle::archive(base, std::move(path), userPRK,
-                                   cryptoProvider, creationMode);
+                                   cryptoProvider, creationMode, options);
 }
 
 auto read_archive_personalization_area(
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 
 namespace vefs
@@ -30,8 +31,15 @@ namespace vefs::crypto
 {
 
 class crypto_provider;
+enum class aead_algorithm : std::uint8_t;
 
 // mirroring <vefs/crypto/provider.hpp>
 auto boringssl_aes_256_gcm_crypto_provider() -> crypto_provider *;
+auto boringssl_chacha20_poly1305_crypto_provider() -> crypto_provider *;
+auto boringssl_aes_256_gcm_siv_crypto_provider() -> crypto_provider *;
+//! AES-256-GCM if the host has AES instructions, ChaCha20-Poly1305 otherwise
+auto boringssl_preferred_crypto_provider() -> crypto_provider *;
+//! the builtin provider for the given algorithm or nullptr
+auto boringssl_crypto_provider(aead_algorithm algorithm) -> crypto_provider *;
 
 } // namespace vefs::crypto
@@ -0,0 +1,35 @@
+#pragma once
+
+namespace vefs
+{
+
+/**
+ * @brief Selects how the sector caches decide which sectors to evict.
+ */
+enum class cache_policy
+{
+    /**
+     * @brief Evicts the least recently used sector.
+     */
+    least_recently_used,
+    /**
+     * @brief Segmented LRU; sectors which have been accessed repeatedly are
+     * protected from sectors which have been accessed only once, i.e. a scan
+     * doesn't flush the working set.
+     */
+    segmented_least_recently_used,
+    /**
+     * @brief W-TinyLFU; sectors are admitted based on their estimated access
+     * frequency which makes it scan resistant and well suited for skewed
+     * access patterns.
+     */
+    w_tinylfu,
+    /**
+     * @brief CLOCK; approximates LRU with a reference bit per sector which is
+     * set on every hit, i.e. hits don't need any further bookkeeping. Suited
+     * for workloads with very high hit rates.
+     */
+    clock,
+};
+
+} // namespace vefs
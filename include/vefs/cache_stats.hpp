@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+
+namespace vefs
+{
+
+/**
+ * @brief A snapshot of the counters of one or more sector caches.
+ */
+struct cache_stats
+{
+    //! the number of sector lookups which have been served by the cache
+    std::uint64_t hits = 0U;
+    //! the number of sectors which had to be read and decrypted
+    std::uint64_t misses = 0U;
+    //! the number of evicted sectors which had to be written back first
+    std::uint64_t dirty_evictions = 0U;
+    //! the number of evictions which replenished the pool of free pages
+    std::uint64_t dead_page_refills = 0U;
+    //! the number of accesses which have been hidden from the eviction policy
+    //! due to an overflowing access record queue
+    std::uint64_t access_record_drops = 0U;
+
+    auto operator+=(cache_stats const &other) noexcept -> cache_stats &
+    {
+        hits += other.hits;
+        misses += other.misses;
+        dirty_evictions += other.dirty_evictions;
+        dead_page_refills += other.dead_page_refills;
+        access_record_drops += other.access_record_drops;
+        return *this;
+    }
+
+    friend inline auto operator==(cache_stats const &,
+                                  cache_stats const &) noexcept -> bool
+            = default;
+};
+
+} // namespace vefs
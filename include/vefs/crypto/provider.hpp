@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+#include <span>
 #include <type_traits>
 
 #include <vefs/disappointment.hpp>
@@ -9,6 +12,40 @@
 namespace vefs::crypto
 {
 
+/**
+ * @brief Identifies the AEAD construction of a provider. It is recorded in
+ *        the static archive header, i.e. the values must never change.
+ */
+enum class aead_algorithm : std::uint8_t
+{
+    //! a custom provider which can't be substituted by a builtin one
+    unspecified = 0,
+    aes_256_gcm = 1,
+    chacha20_poly1305 = 2,
+    aes_256_gcm_siv = 3,
+};
+
+/**
+ * @brief The buffers of a single box within a box_seal_batch() call.
+ */
+struct seal_box
+{
+    rw_dynblob ciphertext;
+    rw_dynblob mac;
+    ro_dynblob key_material;
+    ro_dynblob plaintext;
+};
+/**
+ * @brief The buffers of a single box within a box_open_batch() call.
+ */
+struct open_box
+{
+    rw_dynblob plaintext;
+    ro_dynblob key_material;
+    ro_dynblob ciphertext;
+    ro_dynblob mac;
+};
+
 class crypto_provider
 {
 public:
@@ -23,6 +60,39 @@ public:
                                   ro_dynblob mac) const noexcept
             = 0;
 
+    /**
+     * seals many independent boxes with a single call; it stops at the first
+     * box which can't be sealed, i.e. the preceding boxes have been sealed,
+     * and reports its index via failedBox
+     */
+    virtual result<void> box_seal_batch(std::span<seal_box const> boxes,
+                                        std::size_t &failedBox) const noexcept
+    {
+        for (failedBox = 0U; failedBox < boxes.size(); ++failedBox)
+        {
+            auto const &box = boxes[failedBox];
+            VEFS_TRY(box_seal(box.ciphertext, box.mac, box.key_material,
+                              box.plaintext));
+        }
+        return success();
+    }
+    /**
+     * opens many independent boxes with a single call; it stops at the first
+     * box which can't be opened, i.e. the preceding boxes have been opened,
+     * and reports its index via failedBox
+     */
+    virtual result<void> box_open_batch(std::span<open_box const> boxes,
+                                        std::size_t &failedBox) const noexcept
+    {
+        for (failedBox = 0U; failedBox < boxes.size(); ++failedBox)
+        {
+            auto const &box = boxes[failedBox];
+            VEFS_TRY(box_open(box.plaintext, box.key_material, box.ciphertext,
+                              box.mac));
+        }
+        return success();
+    }
+
     /**
      * calculates cryptographically save random bytes
      */
@@ -36,14 +106,19 @@ public:
             = 0;
 
     std::size_t const key_material_size;
+    aead_algorithm const algorithm;
 
 protected:
-    constexpr crypto_provider(std::size_t keyMaterialSize)
+    constexpr crypto_provider(std::size_t keyMaterialSize,
+                              aead_algorithm aead
+                              = aead_algorithm::unspecified)
         : key_material_size{keyMaterialSize}
+        , algorithm{aead}
     {
     }
     constexpr crypto_provider()
         : key_material_size{5}
+        , algorithm{aead_algorithm::unspecified}
     {
     }
     virtual ~crypto_provider() = default;
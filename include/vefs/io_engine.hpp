@@ -0,0 +1,24 @@
+#pragma once
+
+namespace vefs
+{
+
+/**
+ * @brief Selects how sector reads and writes are issued against the archive
+ * file.
+ */
+enum class io_engine
+{
+    /**
+     * @brief Every sector i/o is a blocking positional read or write.
+     */
+    synchronous,
+    /**
+     * @brief Sector i/o is submitted through an io_uring instance with the
+     * i/o buffers registered as fixed buffers, so that requests of many
+     * threads can be in flight at once. Only supported on Linux.
+     */
+    io_uring,
+};
+
+} // namespace vefs
@@ -6,6 +6,9 @@ dplx_target_sources(vefs # core
     PUBLIC
         archive.hpp
         archive_fwd.hpp
+        cache_policy.hpp
+        cache_stats.hpp
+        io_engine.hpp
         llfio.hpp
         span.hpp
 
@@ -32,6 +35,8 @@ dplx_target_sources(vefs # detail
         detail/archive_header.hpp
         detail/archive_file_id.hpp
         detail/block_manager.hpp
+        detail/cache_budget.cpp
+        detail/cache_budget.hpp
         detail/file_crypto_ctx.cpp
         detail/file_crypto_ctx.hpp
         detail/io_buffer_manager.hpp
@@ -74,12 +79,20 @@ dplx_target_sources(vefs # cache
         cache/cache_mt.hpp
         cache/cache_page.cpp
         cache/cache_page.hpp
+        cache/clock_policy.cpp
+        cache/clock_policy.hpp
         cache/eviction_policy.cpp
         cache/eviction_policy.hpp
+        cache/index_list.cpp
+        cache/index_list.hpp
         cache/lru_policy.cpp
         cache/lru_policy.hpp
+        cache/sharded_cache_mt.cpp
+        cache/sharded_cache_mt.hpp
         cache/slru_policy.cpp
         cache/slru_policy.hpp
+        cache/variant_policy.cpp
+        cache/variant_policy.hpp
         cache/w-tinylfu_policy.cpp
         cache/w-tinylfu_policy.hpp
 )
@@ -121,6 +134,8 @@ dplx_target_sources(vefs # crypto
         crypto/kdf.cpp
         crypto/kdf.hpp
 
+        crypto/keystream.hpp
+
         crypto/counter.cpp
         crypto/counter.hpp
 )
@@ -148,6 +163,12 @@ dplx_target_sources(vefs # platform
         platform/platform.cpp
         platform/windows-proper.h
 
+        platform/io_uring_queue.cpp
+        platform/io_uring_queue.hpp
+
+        platform/page_allocator.cpp
+        platform/page_allocator.hpp
+
         platform/thread_pool.cpp
         platform/thread_pool_gen.hpp
         platform/thread_pool_gen.cpp
@@ -232,6 +253,7 @@ if (BUILD_TESTING)
             test_utils/test-utils.cpp
             test_utils/test-utils.hpp
 
+            cache_budget.test.cpp
             io_buffer_manager.test.cpp
             sector_device-tests.cpp
             sector_tree_mt-tests.cpp
@@ -254,10 +276,38 @@ if (BUILD_TESTING)
             vefs/cache/bloom_filter.test.cpp
             vefs/cache/cache_mt.test.cpp
             vefs/cache/cache_page.test.cpp
+            vefs/cache/clock_policy.test.cpp
             vefs/cache/eviction_policy.test.cpp
+            vefs/cache/index_list.test.cpp
             vefs/cache/lru_policy.test.cpp
+            vefs/cache/sharded_cache_mt.test.cpp
             vefs/cache/slru_policy.test.cpp
             vefs/cache/spectral_bloom_filter.test.cpp
+            vefs/cache/variant_policy.test.cpp
             vefs/cache/w-tinylfu_policy.test.cpp
+
+            vefs/crypto/counter.test.cpp
+            vefs/crypto/kdf.test.cpp
+
+            vefs/platform/page_allocator.test.cpp
+     )
+endif()
+
+if (BUILD_BENCHMARKS)
+    dplx_target_sources(vefs-benchmarks PRIVATE
+        MODE VERBATIM
+        BASE_DIR ../benchmarks
+
+        PRIVATE
+            vefs/crypto/boringssl_aead.bench.cpp
+            vefs/detail/file_crypto_ctx.bench.cpp
+     )
+    dplx_target_sources(vefs-benchmarks PRIVATE
+        MODE VERBATIM
+        BASE_DIR ../tests
+
+        PRIVATE
+            test_utils/libb2_none_blake2b_crypto_provider.cpp
+            test_utils/libb2_none_blake2b_crypto_provider.hpp
      )
 endif()
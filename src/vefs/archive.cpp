@@ -120,7 +120,9 @@ auto map_creation_flag(archive_handle::creation mode) noexcept
 auto archive_handle::archive(llfio::file_handle const &file,
                              ro_blob<32> userPRK,
                              crypto::crypto_provider *cryptoProvider,
-                             creation creationMode) -> result<archive_handle>
+                             creation creationMode,
+                             archive_options const &options)
+        -> result<archive_handle>
 {
     if (!file.is_valid() || !file.is_writable())
     {
@@ -143,12 +145,12 @@ auto archive_handle::archive(llfio::file_handle const &file,
     if (!created)
     {
         return archive_handle::open_existing(std::move(clonedHandle),
-                                             cryptoProvider, userPRK);
+                                             cryptoProvider, userPRK, options);
     }
     else
     {
         return archive_handle::create_new(std::move(clonedHandle),
-                                          cryptoProvider, userPRK);
+                                          cryptoProvider, userPRK, options);
     }
 }
 
@@ -156,7 +158,9 @@ auto archive_handle::archive(llfio::path_handle const &base,
                              llfio::path_view path,
                              archive_handle::storage_key_type userPRK,
                              crypto::crypto_provider *cryptoProvider,
-                             creation creationMode) -> result<archive_handle>
+                             creation creationMode,
+                             archive_options const &options)
+        -> result<archive_handle>
 {
     auto mappedCreationMode = map_creation_flag(creationMode);
 
@@ -176,13 +180,13 @@ auto archive_handle::archive(llfio::path_handle const &base,
     if (!created)
     {
         return archive_handle::open_existing(std::move(fileHandle),
-                                             cryptoProvider, userPRK);
+                                             cryptoProvider, userPRK, options);
     }
 
     VEFS_TRY(clonedHandle, fileHandle.reopen());
 
-    if (auto createRx = archive_handle::create_new(std::move(fileHandle),
-                                                   cryptoProvider, userPRK))
+    if (auto createRx = archive_handle::create_new(
+                std::move(fileHandle), cryptoProvider, userPRK, options))
     {
         return std::move(createRx).assume_value();
     }
@@ -196,14 +200,15 @@ auto archive_handle::archive(llfio::path_handle const &base,
 auto archive_handle::open_existing(
         llfio::file_handle mfh,
         crypto::crypto_provider *cryptoProvider,
-        archive_handle::storage_key_type userPRK) noexcept
-        -> result<archive_handle>
+        archive_handle::storage_key_type userPRK,
+        archive_options const &options) noexcept -> result<archive_handle>
 {
     VEFS_TRY(auto &&bundledPrimitives,
              sector_device::open_existing(std::move(mfh), cryptoProvider,
-                                          userPRK));
+                                          userPRK, options.engine));
     auto &&[sectorDevice, filesystemFile, freeSectorFile]
             = std::move(bundledPrimitives);
+    sectorDevice->discard_free_sectors(options.discard_free_sectors);
 
     VEFS_TRY(auto &&sectorAllocator,
              make_unique_rx<detail::archive_sector_allocator>(
@@ -213,8 +218,10 @@ auto archive_handle::open_existing(
                                          &detail::thread_pool::shared()));
 
     vfilesystem_owner filesystem;
-    if (auto openFsRx = vfilesystem::open_existing(
-                *sectorDevice, *sectorAllocator, *workTracker, filesystemFile))
+    if (auto openFsRx = vfilesystem::open_existing(*sectorDevice,
+                                                   *sectorAllocator,
+                                                   *workTracker,
+                                                   filesystemFile, options))
     {
         filesystem = std::move(openFsRx).assume_value();
     }
@@ -242,6 +249,13 @@ auto archive_handle::open_existing(
                 filesystem->crypto_ctx(), filesystemFile.tree_info,
                 sectorAllocator->crypto_ctx(), freeSectorFile.tree_info));
     }
+    if (options.discard_free_sectors)
+    {
+        // the sectors may have been freed while discarding was disabled.
+        // reclaiming their storage is merely an optimization, i.e. a failure
+        // mustn't prevent opening the archive
+        (void)sectorAllocator->discard_free_sectors();
+    }
 
     return result<archive_handle>(
             std::in_place_type<archive_handle>, std::move(sectorDevice),
@@ -252,14 +266,15 @@ auto archive_handle::open_existing(
 auto archive_handle::create_new(
         llfio::file_handle mfh,
         crypto::crypto_provider *cryptoProvider,
-        archive_handle::storage_key_type userPRK) noexcept
-        -> result<archive_handle>
+        archive_handle::storage_key_type userPRK,
+        archive_options const &options) noexcept -> result<archive_handle>
 {
-    VEFS_TRY(
-            auto &&bundledPrimitives,
-            sector_device::create_new(std::move(mfh), cryptoProvider, userPRK));
+    VEFS_TRY(auto &&bundledPrimitives,
+             sector_device::create_new(std::move(mfh), cryptoProvider, userPRK,
+                                       options.engine));
     auto &&[sectorDevice, filesystemFile, freeSectorFile]
             = std::move(bundledPrimitives);
+    sectorDevice->discard_free_sectors(options.discard_free_sectors);
 
     VEFS_TRY(auto &&sectorAllocator,
              make_unique_rx<detail::archive_sector_allocator>(
@@ -273,7 +288,8 @@ auto archive_handle::create_new(
 
     vfilesystem_owner filesystem;
     if (auto crx = vfilesystem::create_new(*sectorDevice, *sectorAllocator,
-                                           *workTracker, filesystemFile))
+                                           *workTracker, filesystemFile,
+                                           options))
     {
         filesystem = std::move(crx).assume_value();
     }
@@ -578,6 +594,11 @@ auto vefs::archive_handle::list_files() -> std::vector<std::string>
     return mFilesystem->list_files();
 }
 
+auto archive_handle::cache_stats() -> vefs::cache_stats
+{
+    return mFilesystem->cache_stats();
+}
+
 auto archive_handle::extract(llfio::path_view sourceFilePath,
                              llfio::path_view targetBasePath) -> result<void>
 {
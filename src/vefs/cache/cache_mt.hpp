@@ -1,9 +1,14 @@
 #pragma once
 
+#include <cstdint>
+
+#include <algorithm>
+#include <atomic>
 #include <concepts>
+#include <condition_variable>
+#include <future>
 #include <mutex>
-#include <numeric>
-#include <ranges>
+#include <optional>
 #include <semaphore>
 #include <span>
 #include <thread>
@@ -27,7 +32,9 @@
 
 #include <vefs/cache/cache_page.hpp>
 #include <vefs/cache/eviction_policy.hpp>
+#include <vefs/cache_stats.hpp>
 #include <vefs/disappointment.hpp>
+#include <vefs/platform/thread_pool.hpp>
 #include <vefs/utils/object_storage.hpp>
 #include <vefs/utils/unordered_map_mt.hpp>
 
@@ -60,6 +67,37 @@ concept cache_traits
     { p.purge(purgeContext, key, value) } noexcept
         -> tryable;
 };
+
+//! traits which can load several pages with a single call, e.g. in order to
+//! coalesce their i/o; at most max_batch_size pages are passed at once
+template <typename P>
+concept cache_batch_load_traits
+    =  cache_traits<P>
+    && requires(P &&p,
+                typename P::load_context const &loadContext,
+                std::span<typename P::key_type const> keys,
+                std::span<utils::object_storage<typename P::value_type> *const>
+                        storages)
+{
+    { P::max_batch_size } -> std::convertible_to<std::size_t>;
+    { p.load_many(loadContext, keys, storages) } noexcept
+        -> tryable;
+};
+
+//! traits which can synchronize several pages with a single call, e.g. in
+//! order to coalesce their i/o; at most max_batch_size pages are passed at
+//! once
+template <typename P>
+concept cache_batch_sync_traits
+    =  cache_traits<P>
+    && requires(P &&p,
+                std::span<typename P::key_type const> keys,
+                std::span<typename P::value_type *const> values)
+{
+    { P::max_batch_size } -> std::convertible_to<std::size_t>;
+    { p.sync_many(keys, values) } noexcept
+        -> tryable;
+};
 // clang-format on
 
 template <typename T, typename Alloc = std::allocator<T>>
@@ -99,9 +137,14 @@ using default_init_allocator_for
 /**
  * @brief An associative fixed size key-value cache
  *
- * The cache only allocates memory on construction.
- *
+ * The cache only allocates memory on construction. The sole exception are
+ * the workers which sync_all() dispatches to the write-back executor; if they
+ * can't be allocated, the calling thread synchronizes the pages on its own.
  *
+ * If a write-back executor is supplied, dirty pages at the cold end of the
+ * eviction order are synchronized in the background as soon as their share
+ * crosses a watermark, i.e. evictions rarely need to synchronize a victim on
+ * the thread which requested a page.
  */
 template <cache_traits Traits>
 class cache_mt
@@ -152,16 +195,49 @@ private:
     std::vector<page_state, allocator_for<page_state>> mPageCtrl;
     std::vector<value_storage, value_storage_allocator> mPage;
     moodycamel::ConcurrentQueue<access_record> mAccessRecords;
-    std::mutex mDeadPagesSync;
+    // the dead pages form a lock-free stack linked through mDeadPageLinks;
+    // the head packs the top index with a modification tag to defeat ABA
+    std::atomic<std::uint64_t> mDeadPagesHead;
     std::atomic<index_type> mNumDeadPages;
-    std::vector<index_type, allocator_for<index_type>> mDeadPages;
+    std::vector<std::atomic<index_type>, allocator_for<std::atomic<index_type>>>
+            mDeadPageLinks;
     index_type mDeadPageTarget;
     std::mutex mEvictionSync;
     eviction_policy mEvictionPolicy;
+    //! whether hits are queued as access records or only set the reference
+    //! bit of their page, see needs_access_replay()
+    bool mReplayAccesses;
+    thread_pool *mWriteBackExecutor;
+    // serializes write_back() and sync_all()
+    std::mutex mWriteBackSync;
+    // the pages of the rank which is currently synchronized by sync_all();
+    // reserved upfront and guarded by mWriteBackSync
+    std::vector<handle, allocator_for<handle>> mSyncQueue;
+    std::condition_variable mWriteBackDone;
+    std::atomic<bool> mWriteBackScheduled;
+    // statistics, see stats()
+    std::atomic<std::uint64_t> mNumHits;
+    std::atomic<std::uint64_t> mNumMisses;
+    std::atomic<std::uint64_t> mNumDirtyEvictions;
+    std::atomic<std::uint64_t> mNumDeadPageRefills;
+    std::atomic<std::uint64_t> mNumAccessRecordDrops;
+
+    //! the number of pages at the cold end of the eviction order which are
+    //! considered by write_back()
+    static constexpr unsigned write_back_window = 64U;
+    //! a background write-back is scheduled as soon as more than
+    //! 1/write_back_watermark of the write_back_window pages are dirty
+    static constexpr unsigned write_back_watermark = 4U;
 
 public:
     ~cache_mt() noexcept
     {
+        {
+            std::unique_lock writeBackLock{mWriteBackSync};
+            mWriteBackDone.wait(writeBackLock, [this] {
+                return !mWriteBackScheduled.load(std::memory_order::acquire);
+            });
+        }
         if (!std::is_trivially_destructible_v<value_type>)
         {
             typename page_state::state_type gen;
@@ -203,9 +279,16 @@ public:
             }
         }
     }
+    /**
+     * @param policyArgs are passed to the eviction policy constructor after
+     *        the pages, the capacity and the allocator
+     */
+    template <typename... PolicyArgs>
     cache_mt(index_type cacheSize,
              typename traits_type::initializer_type traitsInitializer,
-             allocator_type const &alloc = allocator_type())
+             thread_pool *writeBackExecutor = nullptr,
+             allocator_type const &alloc = allocator_type(),
+             PolicyArgs &&...policyArgs)
         : mTraits(static_cast<decltype(traitsInitializer) &&>(
                   traitsInitializer))
         , mIndex(derive_index_size(cacheSize), {}, {}, alloc)
@@ -213,15 +296,36 @@ public:
         , mPage(cacheSize, alloc)
         , mAccessRecords(
                   cacheSize, 0U, std::thread::hardware_concurrency() * 2U)
-        , mDeadPagesSync()
+        , mDeadPagesHead(0U)
         , mNumDeadPages(cacheSize)
-        , mDeadPages(cacheSize, alloc)
+        , mDeadPageLinks(cacheSize, alloc)
         , mDeadPageTarget(std::thread::hardware_concurrency() * 2U)
         , mEvictionSync()
-        , mEvictionPolicy(std::span(mPageCtrl), mPageCtrl.size(), alloc)
+        , mEvictionPolicy(std::span(mPageCtrl),
+                          mPageCtrl.size(),
+                          alloc,
+                          std::forward<PolicyArgs>(policyArgs)...)
+        , mReplayAccesses(needs_access_replay(mEvictionPolicy))
+        , mWriteBackExecutor(writeBackExecutor)
+        , mWriteBackSync()
+        , mSyncQueue(alloc)
+        , mWriteBackDone()
+        , mWriteBackScheduled(false)
+        , mNumHits(0U)
+        , mNumMisses(0U)
+        , mNumDirtyEvictions(0U)
+        , mNumDeadPageRefills(0U)
+        , mNumAccessRecordDrops(0U)
     {
-        std::ranges::reverse_view deadPages(mDeadPages);
-        std::iota(deadPages.begin(), deadPages.end(), index_type{});
+        mSyncQueue.reserve(cacheSize);
+
+        // the dead pages are handed out in ascending order; the last one
+        // links to size() which terminates the stack
+        for (index_type i = 0U; i < cacheSize; ++i)
+        {
+            mDeadPageLinks[i].store(static_cast<index_type>(i + 1U),
+                                    std::memory_order::relaxed);
+        }
     }
 
     auto size() const noexcept -> index_type
@@ -229,6 +333,22 @@ public:
         return static_cast<index_type>(mPageCtrl.size());
     }
 
+    /**
+     * @brief Takes a snapshot of the cache statistics. The counters are
+     *        sampled individually, i.e. the snapshot isn't atomic.
+     */
+    auto stats() const noexcept -> cache_stats
+    {
+        using enum std::memory_order;
+        return {
+                .hits = mNumHits.load(relaxed),
+                .misses = mNumMisses.load(relaxed),
+                .dirty_evictions = mNumDirtyEvictions.load(relaxed),
+                .dead_page_refills = mNumDeadPageRefills.load(relaxed),
+                .access_record_drops = mNumAccessRecordDrops.load(relaxed),
+        };
+    }
+
     auto try_pin(key_type const &key) noexcept -> handle
     {
         entry_info entry;
@@ -244,8 +364,6 @@ public:
     auto pin_or_load(load_context const &ctx, key_type const &key) noexcept
             -> result<handle>
     {
-        using enum std::memory_order;
-        using enum cache_replacement_result;
         handle h;
 
         bool found;
@@ -268,78 +386,103 @@ public:
         }
 
         // nope, aquire an initialization slot
-        bool shouldEvictOne = acquire_page(entry);
-
-        auto &ctrl = mPageCtrl[entry.index];
-        auto &page = mPage[entry.index];
-
-        [[maybe_unused]] auto const targetReplacementMode
-                = ctrl.try_start_replace(entry.generation);
-        assert(targetReplacementMode == dead);
-
-        entry_info foundEntry;
-        // try to broadcast where value for key will appear
-        if (!mIndex.uprase_fn(
-                    key,
-                    [this, &h,
-                     &foundEntry](entry_info const &indexEntry) noexcept {
-                        // someone was faster than us
-                        // forcefully reference the page in order to prevent its
-                        // untimely unbecoming during the retry
-                        // note that at this point we do not know aything about
-                        // its contents and state
-                        h = handle{dplx::cncr::intrusive_ptr_acquire(
-                                           &mPageCtrl[indexEntry.index]),
-                                   mPage[indexEntry.index].pointer()};
-                        foundEntry = indexEntry;
-                        return false;
-                    },
-                    entry))
+        VEFS_TRY(auto const reserved, reserve_page(key, entry, h));
+        if (!reserved)
         {
-            ctrl.cancel_replace();
-            release_page(entry.index);
-
+            // someone was faster than us
             found = true;
-            entry = foundEntry;
             goto retry;
         }
-        dplx::scope_guard indexRollback
-                = [this, &key, &entry, &ctrl]() noexcept {
-                      if (entry.generation != page_state::invalid_generation)
-                      {
-                          mIndex.erase(key);
-                          ctrl.cancel_replace();
-                          release_page(entry.index);
-                      }
-                  };
-
-        if (shouldEvictOne)
-        {
-            VEFS_TRY(evict_one(key, entry.index));
-        }
-        else
-        {
-            std::lock_guard evictionLock{mEvictionSync};
-            mEvictionPolicy.insert(key, entry.index);
-        }
-        dplx::scope_guard evictionRollback = [this, &key, &entry]() noexcept {
+        dplx::scope_guard loadRollback = [this, &key, &entry]() noexcept {
             if (entry.generation != page_state::invalid_generation)
             {
-                std::lock_guard evictionLock{mEvictionSync};
-                mEvictionPolicy.on_purge(key, entry.index);
+                abandon_page(key, entry.index);
             }
         };
 
-        VEFS_TRY(auto loaded, mTraits.load(ctx, key, page));
+        auto &ctrl = mPageCtrl[entry.index];
+        VEFS_TRY(auto loaded, mTraits.load(ctx, key, mPage[entry.index]));
 
+        mNumMisses.fetch_add(1U, std::memory_order::relaxed);
         ctrl.finish_replace(key);
         if (loaded.second)
         {
             ctrl.mark_dirty();
+            if constexpr (cache_dirt_tracking_value<value_type, key_type>)
+            {
+                loaded.first->on_dirtied(key);
+            }
         }
         entry.generation = page_state::invalid_generation;
         return handle{dplx::cncr::intrusive_ptr_import(&ctrl), loaded.first};
     }
+    /**
+     * @brief Loads the pages of the given keys which aren't cached yet with
+     *        a single Traits::load_many() call. The pages aren't pinned.
+     *
+     * Keys which are already cached or are being loaded by another thread
+     * are skipped. If a page can't be reserved, the pages reserved so far are
+     * loaded nevertheless.
+     */
+    auto load_many(load_context const &ctx,
+                   std::span<key_type const> keys) noexcept -> result<void>
+        requires cache_batch_load_traits<Traits>
+    {
+        using boost::container::static_vector;
+
+        constexpr std::size_t maxBatchSize = Traits::max_batch_size;
+        static_vector<key_type, maxBatchSize> reservedKeys;
+        static_vector<index_type, maxBatchSize> reservedPages;
+        static_vector<value_storage *, maxBatchSize> storages;
+
+        dplx::scope_guard loadRollback
+                = [this, &reservedKeys, &reservedPages]() noexcept {
+                      for (std::size_t i = 0U; i < reservedKeys.size(); ++i)
+                      {
+                          abandon_page(reservedKeys[i], reservedPages[i]);
+                      }
+                  };
+
+        for (auto const &key : keys.first(std::min(keys.size(), maxBatchSize)))
+        {
+            entry_info entry;
+            if (mIndex.find(key, entry))
+            {
+                continue;
+            }
+            handle racer;
+            auto reserverx = reserve_page(key, entry, racer);
+            if (reserverx.has_failure())
+            {
+                break;
+            }
+            if (reserverx.assume_value())
+            {
+                reservedKeys.push_back(key);
+                reservedPages.push_back(entry.index);
+                storages.push_back(&mPage[entry.index]);
+            }
+        }
+        if (reservedKeys.empty())
+        {
+            return oc::success();
+        }
+
+        VEFS_TRY(mTraits.load_many(ctx,
+                                   std::span<key_type const>(reservedKeys),
+                                   std::span<value_storage *const>(storages)));
+
+        mNumMisses.fetch_add(reservedKeys.size(), std::memory_order::relaxed);
+        for (std::size_t i = 0U; i < reservedKeys.size(); ++i)
+        {
+            auto &ctrl = mPageCtrl[reservedPages[i]];
+            ctrl.finish_replace(reservedKeys[i]);
+            // drops the reference which has been created by the reservation
+            (void)dplx::cncr::intrusive_ptr_import(&ctrl);
+        }
+        reservedKeys.clear();
+        return oc::success();
+    }
 
     auto purge(purge_context &ctx, key_type const &key) noexcept -> result<void>
     {
@@ -398,41 +541,276 @@ public:
     }
     auto sync_all() noexcept -> result<bool>
     {
-        using boost::container::static_vector;
-        constexpr index_type chunkSize = 512;
+        return sync_all([](key_type const &) noexcept { return 0; });
+    }
+    /**
+     * @brief Synchronizes all dirty pages in ascending order of their rank.
+     *
+     * Pages of equal rank are synchronized concurrently on the write-back
+     * executor (if any). Therefore the synchronization of a page must only
+     * modify pages of a higher rank, e.g. a tree node must be ranked above
+     * its children.
+     *
+     * @return true if any page was dirty
+     */
+    template <typename RankFn>
+    auto sync_all(RankFn &&rankOf) noexcept -> result<bool>
+    {
+        return sync_all_if([](key_type const &) noexcept { return true; },
+                           rankOf);
+    }
+    /**
+     * @brief Synchronizes the dirty pages whose key satisfies the predicate
+     *        in ascending order of their rank (see above).
+     *
+     * @return true if any selected page was dirty
+     */
+    template <typename Predicate, typename RankFn>
+    auto sync_all_if(Predicate &&selects, RankFn &&rankOf) noexcept
+            -> result<bool>
+    {
+        using rank_type = std::remove_cvref_t<
+                std::invoke_result_t<RankFn &, key_type const &>>;
 
-        bool anyDirty = false;
-        index_type const numPages = size();
-        static_vector<handle, chunkSize> syncQueue;
+        std::lock_guard writeBackLock{mWriteBackSync};
+
+        // holds at most one handle per page, i.e. it never reallocates
+        auto &syncQueue = mSyncQueue;
+        dplx::scope_guard syncQueueReset
+                = [&syncQueue]() noexcept { syncQueue.clear(); };
 
-        for (index_type i = 0; i < numPages;)
+        bool anyDirty = false;
+        std::optional<rank_type> previousRank;
+        for (;;)
         {
-            do
+            for (index_type i = 0, numPages = size(); i < numPages; ++i)
             {
                 auto *const ctrl = &mPageCtrl[i];
                 if (ctrl->try_acquire_wait())
                 {
                     if (auto h = dplx::cncr::intrusive_ptr_import(ctrl);
-                        ctrl->is_dirty())
+                        ctrl->is_dirty() && selects(ctrl->key()))
                     {
                         syncQueue.push_back(
                                 handle{std::move(h), mPage[i].pointer()});
                     }
                 }
             }
-            while (++i < numPages && syncQueue.size() < syncQueue.capacity());
+            if (syncQueue.empty())
+            {
+                break;
+            }
+            anyDirty = true;
 
-            anyDirty = anyDirty || syncQueue.size() > 0U;
-            for (auto &h : syncQueue)
+            rank_type rank = rankOf(syncQueue.front().key());
+            for (auto const &h : syncQueue)
             {
-                VEFS_TRY(sync(h));
-                h = handle{};
+                rank = std::min(rank, rankOf(h.key()));
+            }
+            if (previousRank.has_value() && !(*previousRank < rank))
+            {
+                // the remaining pages have been modified concurrently, i.e.
+                // they are left to the next invocation
+                break;
             }
+            std::erase_if(syncQueue, [&rankOf, &rank](handle const &h) {
+                return rankOf(h.key()) != rank;
+            });
+
+            VEFS_TRY(sync_concurrently(syncQueue));
             syncQueue.clear();
+            previousRank = rank;
         }
         return anyDirty;
     }
 
+    /**
+     * @brief Synchronizes the cached dirty pages of the given keys
+     *        concurrently without scanning the whole cache.
+     *
+     * The keys must be unique and their pages must be of equal rank, see
+     * sync_all(). Keys which aren't cached (anymore) are skipped.
+     *
+     * @return true if any given page was dirty
+     */
+    auto sync_keys(std::span<key_type const> keys) noexcept -> result<bool>
+    {
+        std::lock_guard writeBackLock{mWriteBackSync};
+
+        // holds at most one handle per page, i.e. it never reallocates
+        auto &syncQueue = mSyncQueue;
+        dplx::scope_guard syncQueueReset
+                = [&syncQueue]() noexcept { syncQueue.clear(); };
+
+        for (auto const &key : keys)
+        {
+            entry_info entry;
+            if (!mIndex.find(key, entry))
+            {
+                continue;
+            }
+            // synchronizing a page doesn't count as an access, i.e. it is
+            // pinned without try_acquire_entry()
+            auto *const ctrl = &mPageCtrl[entry.index];
+            if (!ctrl->try_acquire_wait(key, entry.generation))
+            {
+                continue;
+            }
+            if (auto h = dplx::cncr::intrusive_ptr_import(ctrl);
+                ctrl->is_dirty())
+            {
+                syncQueue.push_back(
+                        handle{std::move(h), mPage[entry.index].pointer()});
+            }
+        }
+        if (syncQueue.empty())
+        {
+            return false;
+        }
+        VEFS_TRY(sync_concurrently(syncQueue));
+        return true;
+    }
+
+    /**
+     * @brief Determines the lowest rank of the dirty pages whose key satisfies
+     *        the predicate.
+     *
+     * @return the lowest rank or nothing if no selected page is dirty
+     */
+    template <typename Predicate, typename RankFn>
+    auto min_dirty_rank_if(Predicate &&selects, RankFn &&rankOf) noexcept
+            -> std::optional<std::remove_cvref_t<
+                    std::invoke_result_t<RankFn &, key_type const &>>>
+    {
+        using rank_type = std::remove_cvref_t<
+                std::invoke_result_t<RankFn &, key_type const &>>;
+
+        std::optional<rank_type> minRank;
+        for (index_type i = 0, numPages = size(); i < numPages; ++i)
+        {
+            auto *const ctrl = &mPageCtrl[i];
+            if (!ctrl->try_acquire_wait())
+            {
+                continue;
+            }
+            auto const pin = dplx::cncr::intrusive_ptr_import(ctrl);
+            if (!ctrl->is_dirty() || !selects(ctrl->key()))
+            {
+                continue;
+            }
+            if (auto const rank = rankOf(ctrl->key());
+                !minRank.has_value() || rank < *minRank)
+            {
+                minRank = rank;
+            }
+        }
+        return minRank;
+    }
+
+    /**
+     * @brief Drops every unpinned page whose key satisfies the predicate
+     *        without synchronizing it.
+     *
+     * Pages which are only pinned by other selected pages, e.g. by their
+     * children, are dropped as soon as the pinning pages are gone.
+     *
+     * @return the number of selected pages which remain pinned
+     */
+    template <typename Predicate>
+    auto discard_if(Predicate &&selects) noexcept -> index_type
+    {
+        // no page may be synchronized while it is being discarded
+        std::lock_guard writeBackLock{mWriteBackSync};
+
+        index_type numPinned = 0;
+        index_type numPinnedPreviously;
+        do
+        {
+            numPinnedPreviously = numPinned;
+            numPinned = 0;
+            for (index_type i = 0, numPages = size(); i < numPages; ++i)
+            {
+                auto *const ctrl = &mPageCtrl[i];
+                // blocks while the page is being replaced, e.g. by a dirty
+                // eviction which synchronizes it through its owner; the
+                // owner may only go away once that has finished, therefore
+                // a failure means that the page has actually been evicted
+                if (!ctrl->try_acquire_wait())
+                {
+                    continue;
+                }
+                auto pin = dplx::cncr::intrusive_ptr_import(ctrl);
+                if (!selects(ctrl->key()))
+                {
+                    continue;
+                }
+                if (!ctrl->try_start_purge())
+                {
+                    numPinned += 1;
+                    continue;
+                }
+
+                mIndex.erase(ctrl->key());
+                {
+                    std::lock_guard evictionLock{mEvictionSync};
+                    (void)mEvictionPolicy.on_purge(ctrl->key(), i);
+                }
+                mPage[i].destroy();
+                pin.release()->purge_finish();
+                release_page(i);
+            }
+        }
+        while (numPinned != numPinnedPreviously);
+
+        return numPinned;
+    }
+
+    /**
+     * @brief Synchronizes the dirty pages which are next in line for eviction
+     *        so that subsequent evictions find clean victims.
+     * @return the number of synchronized pages
+     */
+    auto write_back() noexcept -> result<unsigned>
+    {
+        using boost::container::static_vector;
+
+        std::lock_guard writeBackLock{mWriteBackSync};
+
+        static_vector<handle, write_back_window> syncQueue;
+        {
+            std::lock_guard evictionLock{mEvictionSync};
+            replay_access_records();
+
+            unsigned numVisited = 0U;
+            for (auto it = mEvictionPolicy.begin(), end = mEvictionPolicy.end();
+                 it != end && numVisited < write_back_window;
+                 ++it, ++numVisited)
+            {
+                if (!it->is_dirty() || !it->try_acquire())
+                {
+                    continue;
+                }
+                auto const where
+                        = static_cast<index_type>(&*it - mPageCtrl.data());
+                handle h{dplx::cncr::intrusive_ptr_import(&*it),
+                         mPage[where].pointer()};
+                if (h.is_dirty())
+                {
+                    syncQueue.push_back(std::move(h));
+                }
+            }
+        }
+
+        unsigned numSynced = 0U;
+        for (auto &h : syncQueue)
+        {
+            VEFS_TRY(sync(h));
+            h = handle{};
+            numSynced += 1U;
+        }
+        return numSynced;
+    }
+
 private:
     auto try_acquire_entry(key_type const &key, entry_info entry) noexcept
             -> handle
@@ -444,10 +822,21 @@ private:
             return nullptr;
         }
         auto h = dplx::cncr::intrusive_ptr_import(ctrl);
+        mNumHits.fetch_add(1U, std::memory_order::relaxed);
+
+        if (!mReplayAccesses)
+        {
+            ctrl->mark_referenced();
+            return handle(std::move(h), mPage[entry.index].pointer());
+        }
 
         // log access
         auto const accessRecorded
                 = mAccessRecords.try_enqueue({.key = key, .entry = entry});
+        if (!accessRecorded) [[unlikely]]
+        {
+            mNumAccessRecordDrops.fetch_add(1U, std::memory_order::relaxed);
+        }
         if (auto const approxQueued = mAccessRecords.size_approx();
             !accessRecorded
             || (approxQueued > size() / 2U && approxQueued % 8U == 0U))
@@ -498,9 +887,24 @@ private:
         using enum cache_replacement_result;
         entry_info victim{};
         cache_replacement_result evictionMode = pinned;
+
+        // scheduled after the eviction lock has been released
+        bool writeBackDue = false;
+        dplx::scope_guard writeBackScheduler
+                = [this, &writeBackDue]() noexcept {
+                      if (writeBackDue)
+                      {
+                          schedule_write_back();
+                      }
+                  };
         {
             std::lock_guard evictionLock{mEvictionSync};
             replay_access_records();
+            if (mWriteBackExecutor != nullptr
+                && !mWriteBackScheduled.load(std::memory_order::relaxed))
+            {
+                writeBackDue = is_write_back_due();
+            }
 
             for (auto it = mEvictionPolicy.begin(),
                       end = mEvictionPolicy.end();
@@ -535,8 +939,19 @@ private:
         auto &page = mPage[victim.index];
 
         assert(evictionMode == dirty);
-        // FIXME: think about reinserting a failed eviction
-        VEFS_TRY(mTraits.sync(ctrl.key(), page.value()));
+        if (auto syncrx = mTraits.sync(ctrl.key(), page.value());
+            syncrx.has_failure())
+        {
+            // the victim stays cached and dirty instead of being stuck in
+            // replacement which would block discard_if() forever
+            {
+                std::lock_guard evictionLock{mEvictionSync};
+                mEvictionPolicy.insert(ctrl.key(), victim.index);
+            }
+            ctrl.revert_replace();
+            return std::move(syncrx).as_failure();
+        }
+        mNumDirtyEvictions.fetch_add(1U, std::memory_order::relaxed);
 
         mIndex.erase(ctrl.key());
         page.destroy();
@@ -546,6 +961,233 @@ private:
         return oc::success();
     }
 
+    auto sync_concurrently(std::span<handle const> handles) noexcept
+            -> result<void>
+    {
+        using enum std::memory_order;
+        // the minimum number of pages per additional worker
+        constexpr std::size_t pagesPerWorker = 8U;
+
+        std::atomic<std::size_t> next{0U};
+        std::atomic<bool> failed{false};
+        result<void> failure = oc::success();
+        auto const syncPages = [this, handles, &next, &failed, &failure] {
+            // traits which synchronize a batch at once are handed adjacent
+            // chunks of the queue
+            std::size_t batchSize = 1U;
+            if constexpr (cache_batch_sync_traits<Traits>)
+            {
+                batchSize = Traits::max_batch_size;
+            }
+            for (std::size_t i;
+                 !failed.load(relaxed)
+                 && (i = next.fetch_add(batchSize, relaxed)) < handles.size();)
+            {
+                auto const batch = handles.subspan(
+                        i, std::min(batchSize, handles.size() - i));
+                if (auto syncRx = sync_many(batch); syncRx.has_failure())
+                {
+                    if (!failed.exchange(true, acq_rel))
+                    {
+                        failure = std::move(syncRx);
+                    }
+                }
+            }
+        };
+
+        std::vector<std::future<void>> workers;
+        if (mWriteBackExecutor != nullptr)
+        {
+            auto const numWorkers
+                    = std::min<std::size_t>(std::thread::hardware_concurrency(),
+                                            handles.size() / pagesPerWorker);
+            try
+            {
+                workers.reserve(numWorkers);
+                for (std::size_t i = 0U; i < numWorkers; ++i)
+                {
+                    workers.push_back(
+                            mWriteBackExecutor->twoway_execute(syncPages));
+                }
+            }
+            catch (...)
+            {
+                // the calling thread picks up the slack
+            }
+        }
+        syncPages();
+        for (auto &worker : workers)
+        {
+            worker.wait();
+        }
+        return failure;
+    }
+
+    auto sync_many(std::span<handle const> handles) noexcept -> result<void>
+    {
+        if constexpr (!cache_batch_sync_traits<Traits>)
+        {
+            for (auto const &h : handles)
+            {
+                VEFS_TRY(sync(h));
+            }
+            return oc::success();
+        }
+        else
+        {
+            using boost::container::static_vector;
+
+            constexpr std::size_t maxBatchSize = Traits::max_batch_size;
+            static_vector<handle const *, maxBatchSize> dirty;
+            static_vector<key_type, maxBatchSize> keys;
+            static_vector<value_type *, maxBatchSize> values;
+            for (auto const &h : handles)
+            {
+                if (h.is_dirty())
+                {
+                    h.mark_clean();
+                    dirty.push_back(&h);
+                    keys.push_back(h.key());
+                    values.push_back(const_cast<value_type *>(h.get()));
+                }
+            }
+            if (dirty.empty())
+            {
+                return oc::success();
+            }
+
+            if (auto &&rx = mTraits.sync_many(
+                        std::span<key_type const>(keys),
+                        std::span<value_type *const>(values));
+                !oc::try_operation_has_value(rx))
+            {
+                for (auto const *h : dirty)
+                {
+                    (void)h->as_writable();
+                }
+                return oc::try_operation_return_as(
+                        static_cast<decltype(rx) &&>(rx));
+            }
+            return oc::success();
+        }
+    }
+
+    // assumes the caller owns mEvictionSync
+    auto is_write_back_due() noexcept -> bool
+    {
+        unsigned numVisited = 0U;
+        unsigned numDirty = 0U;
+        for (auto it = mEvictionPolicy.begin(), end = mEvictionPolicy.end();
+             it != end && numVisited < write_back_window; ++it, ++numVisited)
+        {
+            numDirty += it->is_dirty() ? 1U : 0U;
+        }
+        return numDirty * write_back_watermark > numVisited;
+    }
+
+    void schedule_write_back() noexcept
+    {
+        if (mWriteBackScheduled.exchange(true, std::memory_order::acq_rel))
+        {
+            return;
+        }
+        try
+        {
+            mWriteBackExecutor->execute([this]() noexcept {
+                // failures resurface during the next eviction of the page
+                (void)write_back();
+
+                std::lock_guard writeBackLock{mWriteBackSync};
+                mWriteBackScheduled.store(false, std::memory_order::release);
+                mWriteBackDone.notify_all();
+            });
+        }
+        catch (...)
+        {
+            mWriteBackScheduled.store(false, std::memory_order::release);
+        }
+    }
+
+    /**
+     * @brief Reserves a dead page for key and publishes it in the index and
+     *        the eviction policy.
+     *
+     * @return false if another thread was faster, in which case entry
+     *         describes its page and racer references said page
+     */
+    auto reserve_page(key_type const &key,
+                      entry_info &entry,
+                      handle &racer) noexcept -> result<bool>
+    {
+        bool shouldEvictOne = acquire_page(entry);
+
+        auto &ctrl = mPageCtrl[entry.index];
+
+        [[maybe_unused]] auto const targetReplacementMode
+                = ctrl.try_start_replace(entry.generation);
+        assert(targetReplacementMode == cache_replacement_result::dead);
+
+        entry_info foundEntry;
+        // try to broadcast where value for key will appear
+        if (!mIndex.uprase_fn(
+                    key,
+                    [this, &racer,
+                     &foundEntry](entry_info const &indexEntry) noexcept {
+                        // someone was faster than us
+                        // forcefully reference the page in order to prevent its
+                        // untimely unbecoming during the retry
+                        // note that at this point we do not know aything about
+                        // its contents and state
+                        racer = handle{dplx::cncr::intrusive_ptr_acquire(
+                                               &mPageCtrl[indexEntry.index]),
+                                       mPage[indexEntry.index].pointer()};
+                        foundEntry = indexEntry;
+                        return false;
+                    },
+                    entry))
+        {
+            ctrl.cancel_replace();
+            release_page(entry.index);
+
+            entry = foundEntry;
+            return false;
+        }
+        bool published = false;
+        dplx::scope_guard indexRollback
+                = [this, &key, &entry, &ctrl, &published]() noexcept {
+                      if (!published)
+                      {
+                          mIndex.erase(key);
+                          ctrl.cancel_replace();
+                          release_page(entry.index);
+                      }
+                  };
+
+        if (shouldEvictOne)
+        {
+            VEFS_TRY(evict_one(key, entry.index));
+            mNumDeadPageRefills.fetch_add(1U, std::memory_order::relaxed);
+        }
+        else
+        {
+            std::lock_guard evictionLock{mEvictionSync};
+            mEvictionPolicy.insert(key, entry.index);
+        }
+        published = true;
+        return true;
+    }
+    //! reverts reserve_page() if the page couldn't be loaded
+    void abandon_page(key_type const &key, index_type const where) noexcept
+    {
+        {
+            std::lock_guard evictionLock{mEvictionSync};
+            mEvictionPolicy.on_purge(key, where);
+        }
+        mIndex.erase(key);
+        mPageCtrl[where].cancel_replace();
+        release_page(where);
+    }
+
     /**
      * @brief acquires a dead page
      * @param page will be set to the acquired page index and its generation
@@ -574,20 +1216,45 @@ private:
                 break;
             }
         }
-        std::lock_guard deadPagesLock{mDeadPagesSync};
-        entry.index = mDeadPages.back();
-        mDeadPages.pop_back();
-        return mDeadPages.size() < mDeadPageTarget;
+        // the successful decrement reserved one of the pushed pages, i.e.
+        // the stack can't run empty while we pop
+        auto head = mDeadPagesHead.load(acquire);
+        index_type top;
+        do
+        {
+            top = static_cast<index_type>(head);
+            assert(top < size());
+        }
+        while (!mDeadPagesHead.compare_exchange_weak(
+                head, retag(head, mDeadPageLinks[top].load(relaxed)), acq_rel,
+                acquire));
+
+        entry.index = top;
+        return numDeadPages - 1U < mDeadPageTarget;
     }
     void release_page(index_type which) noexcept
     {
+        using enum std::memory_order;
+        auto head = mDeadPagesHead.load(relaxed);
+        do
         {
-            std::lock_guard deadPagesLock{mDeadPagesSync};
-            mDeadPages.push_back(which);
+            mDeadPageLinks[which].store(static_cast<index_type>(head),
+                                        relaxed);
         }
-        mNumDeadPages.fetch_add(1U, std::memory_order::release);
+        while (!mDeadPagesHead.compare_exchange_weak(
+                head, retag(head, which), release, relaxed));
+
+        mNumDeadPages.fetch_add(1U, release);
         mNumDeadPages.notify_one();
     }
+    //! replaces the top index of a dead page stack head and bumps its tag
+    static constexpr auto retag(std::uint64_t const head,
+                                index_type const top) noexcept
+            -> std::uint64_t
+    {
+        static_assert(sizeof(index_type) <= sizeof(std::uint32_t));
+        return (((head >> 32) + 1U) << 32) | top;
+    }
 
     // assumes the caller owns mEvictionSync
     void replay_access_records() noexcept
@@ -93,6 +93,8 @@ private:
      *       tombstone      ref ctr
      */
     mutable std::atomic<state_type> mValue;
+    //! set on hits for eviction policies which don't replay accesses
+    mutable std::atomic<bool> mReferenced;
 
     key_type mKey;
 
@@ -131,6 +133,7 @@ public:
     }
     cache_page_state() noexcept
         : mValue(tombstone_flag)
+        , mReferenced(false)
         , mKey{}
     {
     }
@@ -155,15 +158,40 @@ public:
     {
         return (mValue.load(std::memory_order::acquire) & ref_ctr_mask) != 0U;
     }
-    void mark_dirty() noexcept
+    //! @return true if the page has been clean before
+    auto mark_dirty() noexcept -> bool
     {
-        mValue.fetch_or(dirt_flag, std::memory_order::release);
+        return (mValue.fetch_or(dirt_flag, std::memory_order::release)
+                & dirt_flag)
+               == 0U;
     }
     void mark_clean() noexcept
     {
         mValue.fetch_and(~dirt_flag, std::memory_order::release);
     }
 
+    [[nodiscard]] auto is_referenced() const noexcept -> bool
+    {
+        return mReferenced.load(std::memory_order::relaxed);
+    }
+    void mark_referenced() const noexcept
+    {
+        // avoid invalidating the cache line if the bit is already set
+        if (!mReferenced.load(std::memory_order::relaxed))
+        {
+            mReferenced.store(true, std::memory_order::relaxed);
+        }
+    }
+    /**
+     * @brief Clears the reference bit.
+     * @return true if the bit had been set
+     */
+    auto clear_referenced() noexcept -> bool
+    {
+        return mReferenced.load(std::memory_order::relaxed)
+               && mReferenced.exchange(false, std::memory_order::relaxed);
+    }
+
     [[nodiscard]] auto contains(state_type const expectedGeneration,
                                 key_type const &expectedKey) const noexcept
             -> bool
@@ -200,6 +228,25 @@ public:
         return false;
     }
 
+    /**
+     * @brief Tries to pin a page of unknown state without blocking.
+     *
+     * Fails if the page is dead or currently being replaced.
+     *
+     * @return true if the page was alive
+     */
+    [[nodiscard]] auto try_acquire() noexcept -> bool
+    {
+        using enum std::memory_order;
+
+        auto const state = mValue.fetch_add(ref_ctr_one, acq_rel);
+        if ((state & tombstone_flag) != 0U)
+        {
+            mValue.fetch_sub(ref_ctr_one, relaxed);
+            return false;
+        }
+        return true;
+    }
     /**
      * @brief Tries to acquire a page of unknown state.
      *
@@ -342,6 +389,7 @@ public:
         using enum std::memory_order;
 
         mKey = std::move(nextKey);
+        mReferenced.store(false, relaxed);
         auto const state = mValue.fetch_and(~dirty_tombstone, release);
 
         if ((state & ref_ctr_mask) > 1U)
@@ -365,6 +413,21 @@ public:
         }
     }
 
+    /**
+     * @brief Reverts a replacement of a dirty page which couldn't be
+     *        synchronized, i.e. the page keeps its key and stays dirty.
+     */
+    void revert_replace() noexcept
+    {
+        auto const state = mValue.fetch_sub(tombstone_flag | ref_ctr_one,
+                                            std::memory_order::release);
+
+        if ((state & ref_ctr_mask) > 1U)
+        {
+            mValue.notify_all();
+        }
+    }
+
     auto try_start_purge() noexcept -> bool
     {
         using enum std::memory_order;
@@ -380,7 +443,7 @@ public:
 
             next = state | dirty_tombstone;
         }
-        while (mValue.compare_exchange_weak(state, next, acq_rel, acquire));
+        while (!mValue.compare_exchange_weak(state, next, acq_rel, acquire));
 
         return true;
     }
@@ -445,6 +508,15 @@ namespace vefs::detail
 template <typename Key, typename Value>
 class cache_handle;
 
+/**
+ * Values which keep track of their dirty pages are notified whenever their
+ * page becomes dirty.
+ */
+template <typename Value, typename Key>
+concept cache_dirt_tracking_value = requires(Value &value, Key const &key) {
+    { value.on_dirtied(key) } noexcept;
+};
+
 template <typename Key, typename V1, typename V2>
     requires std::same_as<std::remove_const_t<V1>, std::remove_const_t<V2>>
 inline auto operator==(cache_handle<Key, V1> const &lhs,
@@ -464,9 +536,12 @@ class cache_handle
 public:
     ~cache_handle() noexcept
     {
-        if (this->operator bool())
+        if (this->operator bool() && base_type::get_handle()->mark_dirty())
         {
-            base_type::get_handle()->mark_dirty();
+            if constexpr (cache_dirt_tracking_value<Value, Key>)
+            {
+                get()->on_dirtied(key());
+            }
         }
     }
     cache_handle() noexcept = default;
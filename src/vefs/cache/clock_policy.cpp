@@ -0,0 +1,5 @@
+#include "vefs/cache/clock_policy.hpp"
+
+namespace vefs::detail
+{
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+
+#include <vefs/cache/cache_page.hpp>
+#include <vefs/cache/index_list.hpp>
+
+namespace vefs::detail
+{
+
+/**
+ * @brief CLOCK (second chance) replacement.
+ *
+ * Hits only set the reference bit of the page state, i.e. accesses need not
+ * be replayed. The hand sweeps the ring of pages and grants every referenced
+ * page a second chance by clearing its bit instead of evicting it.
+ */
+template <typename KeyType,
+          typename IndexType,
+          typename Allocator = std::allocator<void>>
+class clock_policy
+{
+public:
+    using key_type = KeyType;
+    using index_type = IndexType;
+    using page_state = cache_page_state<KeyType>;
+    using list_type = index_list<index_type, Allocator>;
+
+private:
+    page_state *mPages;
+    list_type mRing;
+    // the next eviction candidate; the sentinel iff the ring is empty
+    index_type mHand;
+
+public:
+    // the ring is indexed by page, i.e. it doesn't depend on the capacity
+    clock_policy(std::span<page_state> pages,
+                 [[maybe_unused]] std::size_t capacity,
+                 Allocator const &alloc = Allocator())
+        : mPages(pages.data())
+        , mRing(pages.size(), alloc)
+        , mHand(mRing.sentinel())
+    {
+    }
+
+    /**
+     * @brief Walks the ring twice starting at the hand, i.e. every page is
+     *        visited again after its reference bit has been cleared.
+     */
+    class replacement_iterator
+    {
+        friend class clock_policy;
+
+        clock_policy *mOwner;
+        index_type mHand;
+        std::size_t mRemaining;
+
+    public:
+        constexpr replacement_iterator() noexcept
+            : mOwner{}
+            , mHand{}
+            , mRemaining{}
+        {
+        }
+
+        friend inline auto
+        operator==(replacement_iterator const &left,
+                   replacement_iterator const &right) noexcept -> bool
+                = default;
+
+        explicit replacement_iterator(clock_policy &owner,
+                                      index_type hand,
+                                      std::size_t remaining) noexcept
+            : mOwner(&owner)
+            , mHand(hand)
+            , mRemaining(remaining)
+        {
+        }
+
+        using difference_type = std::ptrdiff_t;
+        using value_type = page_state;
+        using pointer = page_state *;
+        using reference = page_state &;
+        using iterator_category = std::forward_iterator_tag;
+
+        auto operator*() const noexcept -> reference
+        {
+            return mOwner->mPages[mHand];
+        }
+        auto operator->() const noexcept -> pointer
+        {
+            return mOwner->mPages + mHand;
+        }
+
+        auto operator++() noexcept -> replacement_iterator &
+        {
+            mRemaining -= 1U;
+            mHand = mRemaining == 0U ? mOwner->mRing.sentinel()
+                                     : mOwner->successor(mHand);
+            return *this;
+        }
+        auto operator++(int) noexcept -> replacement_iterator
+        {
+            auto old = *this;
+            operator++();
+            return old;
+        }
+
+    private:
+        auto on_second_pass() const noexcept -> bool
+        {
+            return mRemaining <= mOwner->mRing.size();
+        }
+    };
+
+    auto num_managed() const noexcept -> std::size_t
+    {
+        return mRing.size();
+    }
+    constexpr auto needs_access_replay() const noexcept -> bool
+    {
+        return false;
+    }
+
+    auto begin() -> replacement_iterator
+    {
+        return mRing.empty() ? end()
+                             : replacement_iterator{*this, mHand,
+                                                    2U * mRing.size()};
+    }
+    auto end() -> replacement_iterator
+    {
+        return replacement_iterator(*this, mRing.sentinel(), 0U);
+    }
+
+    void insert(key_type const &, index_type where) noexcept
+    {
+        // the new page is the last one to be visited by the hand
+        if (mRing.empty())
+        {
+            mRing.push_back(where);
+            mHand = where;
+        }
+        else
+        {
+            mRing.insert_before(mHand, where);
+        }
+    }
+    auto on_access(key_type const &, index_type where) noexcept -> bool
+    {
+        if (!mRing.contains(where))
+        {
+            return false;
+        }
+        mPages[where].mark_referenced();
+        return true;
+    }
+
+    /**
+     * @brief Evicts the page unless it is referenced in which case its
+     *        reference bit is cleared and pinned is returned.
+     *
+     * The second pass of a sweep ignores the reference bit. Hits set it
+     * without any lock, i.e. a hot workload could otherwise reference every
+     * page again before the hand returns and fail the eviction although no
+     * page is actually pinned.
+     */
+    auto try_evict(replacement_iterator &&which,
+                   index_type &where,
+                   typename page_state::state_type &generation) noexcept
+            -> cache_replacement_result
+    {
+        if (which->clear_referenced() && !which.on_second_pass())
+        {
+            return cache_replacement_result::pinned;
+        }
+        auto const rx = which->try_start_replace(generation);
+        if (rx != cache_replacement_result::pinned)
+        {
+            // the hand passes the pages which got a second chance
+            where = which.mHand;
+            mHand = which.mHand;
+            unlink(which.mHand);
+        }
+        return rx;
+    }
+    auto on_purge(key_type const &, index_type where) noexcept -> bool
+    {
+        if (mRing.contains(where))
+        {
+            unlink(where);
+            return true;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+private:
+    auto successor(index_type const which) const noexcept -> index_type
+    {
+        auto const next = mRing.next(which);
+        return next != mRing.sentinel() ? next : mRing.front();
+    }
+
+    void unlink(index_type const which) noexcept
+    {
+        if (which == mHand)
+        {
+            mHand = mRing.size() > 1U ? successor(which) : mRing.sentinel();
+        }
+        mRing.erase(which);
+    }
+};
+
+} // namespace vefs::detail
@@ -48,4 +48,24 @@ concept eviction_policy
 };
 // clang-format on
 
+/**
+ * @brief Whether the policy relies on on_access() being replayed for every
+ *        hit. Policies which track accesses by the reference bit of the page
+ *        state instead opt out by providing a needs_access_replay() member.
+ */
+template <eviction_policy T>
+constexpr auto needs_access_replay(T const &policy) noexcept -> bool
+{
+    if constexpr (requires {
+                      { policy.needs_access_replay() } -> std::same_as<bool>;
+                  })
+    {
+        return policy.needs_access_replay();
+    }
+    else
+    {
+        return true;
+    }
+}
+
 } // namespace vefs::detail
@@ -0,0 +1,5 @@
+#include "vefs/cache/index_list.hpp"
+
+namespace vefs::detail
+{
+}
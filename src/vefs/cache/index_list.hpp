@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace vefs::detail
+{
+
+/**
+ * @brief A doubly linked list of page indices whose links are stored in two
+ *        arrays indexed by the page index, i.e. every operation is O(1) and
+ *        no allocation happens after construction.
+ *
+ * Each index can be linked at most once. The list is circular with a
+ * sentinel node at index num_indices() which also marks its end.
+ */
+template <typename IndexType, typename Allocator = std::allocator<void>>
+class index_list
+{
+public:
+    using index_type = IndexType;
+
+private:
+    struct links
+    {
+        index_type prev;
+        index_type next;
+    };
+    using allocator_type = typename std::allocator_traits<
+            Allocator>::template rebind_alloc<links>;
+
+    std::vector<links, allocator_type> mLinks;
+    std::size_t mSize;
+
+public:
+    explicit index_list(std::size_t const numIndices,
+                        Allocator const &alloc = Allocator())
+        : mLinks(numIndices + 1U, allocator_type(alloc))
+        , mSize{}
+    {
+        // unlinked nodes point to themselves
+        for (std::size_t i = 0U; i < mLinks.size(); ++i)
+        {
+            mLinks[i] = {static_cast<index_type>(i),
+                         static_cast<index_type>(i)};
+        }
+    }
+
+    auto num_indices() const noexcept -> std::size_t
+    {
+        return mLinks.size() - 1U;
+    }
+    auto size() const noexcept -> std::size_t
+    {
+        return mSize;
+    }
+    auto empty() const noexcept -> bool
+    {
+        return mSize == 0U;
+    }
+
+    auto sentinel() const noexcept -> index_type
+    {
+        return static_cast<index_type>(mLinks.size() - 1U);
+    }
+    //! returns sentinel() if the list is empty
+    auto front() const noexcept -> index_type
+    {
+        return mLinks[sentinel()].next;
+    }
+    auto next(index_type const which) const noexcept -> index_type
+    {
+        return mLinks[which].next;
+    }
+    auto prev(index_type const which) const noexcept -> index_type
+    {
+        return mLinks[which].prev;
+    }
+
+    auto contains(index_type const which) const noexcept -> bool
+    {
+        return mLinks[which].next != which;
+    }
+
+    //! links the unlinked index which before the linked index (or sentinel)
+    void insert_before(index_type const where, index_type const which) noexcept
+    {
+        auto const prevIdx = mLinks[where].prev;
+        mLinks[which] = {prevIdx, where};
+        mLinks[prevIdx].next = which;
+        mLinks[where].prev = which;
+        mSize += 1U;
+    }
+    void push_back(index_type const which) noexcept
+    {
+        insert_before(sentinel(), which);
+    }
+
+    void erase(index_type const which) noexcept
+    {
+        auto const [prevIdx, nextIdx] = mLinks[which];
+        mLinks[prevIdx].next = nextIdx;
+        mLinks[nextIdx].prev = prevIdx;
+        mLinks[which] = {which, which};
+        mSize -= 1U;
+    }
+
+    void move_to_back(index_type const which) noexcept
+    {
+        erase(which);
+        push_back(which);
+    }
+};
+
+} // namespace vefs::detail
@@ -1,12 +1,12 @@
 #pragma once
 
-#include <algorithm>
-#include <concepts>
-#include <ranges>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <span>
-#include <vector>
 
 #include <vefs/cache/cache_page.hpp>
+#include <vefs/cache/index_list.hpp>
 
 namespace vefs::detail
 {
@@ -20,22 +20,20 @@ public:
     using key_type = KeyType;
     using index_type = IndexType;
     using page_state = cache_page_state<KeyType>;
-    using allocator_type = typename std::allocator_traits<
-            Allocator>::template rebind_alloc<index_type>;
-    using list_type = std::vector<index_type, allocator_type>;
+    using list_type = index_list<index_type, Allocator>;
 
 private:
     page_state *mPages;
     list_type mLRU;
 
 public:
+    // the list is indexed by page, i.e. it doesn't depend on the capacity
     least_recently_used_policy(std::span<page_state> pages,
-                               std::size_t capacity,
+                               [[maybe_unused]] std::size_t capacity,
                                Allocator const &alloc = Allocator())
         : mPages(pages.data())
-        , mLRU(alloc)
+        , mLRU(pages.size(), alloc)
     {
-        mLRU.reserve(capacity);
     }
 
     class replacement_iterator
@@ -43,7 +41,7 @@ public:
         friend class least_recently_used_policy;
 
         least_recently_used_policy *mOwner;
-        typename list_type::iterator mHand;
+        index_type mHand;
 
     public:
         constexpr replacement_iterator() noexcept
@@ -59,9 +57,9 @@ public:
 
         explicit replacement_iterator(
                 least_recently_used_policy &owner,
-                typename list_type::iterator hand) noexcept
+                index_type hand) noexcept
             : mOwner(&owner)
-            , mHand(std::move(hand))
+            , mHand(hand)
         {
         }
 
@@ -73,16 +71,16 @@ public:
 
         auto operator*() const noexcept -> reference
         {
-            return mOwner->mPages[*mHand];
+            return mOwner->mPages[mHand];
         }
         auto operator->() const noexcept -> pointer
         {
-            return mOwner->mPages + *mHand;
+            return mOwner->mPages + mHand;
         }
 
         auto operator++() noexcept -> replacement_iterator &
         {
-            ++mHand;
+            mHand = mOwner->mLRU.next(mHand);
             return *this;
         }
         auto operator++(int) noexcept -> replacement_iterator
@@ -100,11 +98,11 @@ public:
 
     auto begin() -> replacement_iterator
     {
-        return replacement_iterator{*this, mLRU.begin()};
+        return replacement_iterator{*this, mLRU.front()};
     }
     auto end() -> replacement_iterator
     {
-        return replacement_iterator(*this, mLRU.end());
+        return replacement_iterator(*this, mLRU.sentinel());
     }
 
     void insert(key_type const &, index_type where) noexcept
@@ -114,14 +112,12 @@ public:
 
     auto on_access(key_type const &, index_type where) noexcept -> bool
     {
-        auto const it = std::ranges::find(mLRU, where);
-        auto const end = mLRU.end();
-        if (it == end)
+        if (!mLRU.contains(where))
         {
             return false;
         }
 
-        std::ranges::rotate(it, std::next(it), end);
+        mLRU.move_to_back(where);
         return true;
     }
 
@@ -133,17 +129,16 @@ public:
         auto const rx = which->try_start_replace(generation);
         if (rx != cache_replacement_result::pinned)
         {
-            where = *which.mHand;
+            where = which.mHand;
             mLRU.erase(which.mHand);
         }
         return rx;
     }
     auto on_purge(key_type const &, index_type where) noexcept -> bool
     {
-        auto const it = std::ranges::find(mLRU, where);
-        if (it != mLRU.end())
+        if (mLRU.contains(where))
         {
-            mLRU.erase(it);
+            mLRU.erase(where);
             return true;
         }
         else
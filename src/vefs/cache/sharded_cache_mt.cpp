@@ -0,0 +1,5 @@
+#include "vefs/cache/sharded_cache_mt.hpp"
+
+namespace vefs::detail
+{
+}
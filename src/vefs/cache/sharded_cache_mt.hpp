@@ -0,0 +1,349 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <boost/container/static_vector.hpp>
+
+#include <vefs/cache/cache_mt.hpp>
+#include <vefs/cache_stats.hpp>
+#include <vefs/disappointment.hpp>
+#include <vefs/hash/hash_algorithm.hpp>
+#include <vefs/hash/spooky_v2.hpp>
+#include <vefs/platform/thread_pool.hpp>
+
+namespace vefs::detail
+{
+
+/**
+ * @brief An associative fixed size key-value cache whose key space is
+ *        partitioned over independent @ref cache_mt shards.
+ *
+ * Every shard has its own eviction policy, dead page list and locks, i.e.
+ * misses of different shards don't contend with each other. The shard of a
+ * key is selected by its hash. Eviction decisions are made per shard and
+ * therefore only approximate the policy of a single cache.
+ */
+template <cache_traits Traits>
+class sharded_cache_mt
+{
+public:
+    using shard_type = cache_mt<Traits>;
+    using traits_type = Traits;
+    using key_type = typename shard_type::key_type;
+    using value_type = typename shard_type::value_type;
+    using allocator_type = typename shard_type::allocator_type;
+    using index_type = decltype(std::declval<shard_type const &>().size());
+
+    using handle = typename shard_type::handle;
+    using writable_handle = typename shard_type::writable_handle;
+
+    using load_context = typename Traits::load_context;
+    using purge_context = typename Traits::purge_context;
+
+    //! the minimum number of pages per shard
+    static constexpr std::size_t min_shard_size = 1024U;
+
+private:
+    std::vector<std::unique_ptr<shard_type>> mShards;
+
+public:
+    /**
+     * @param numShards is clamped to [1, cacheSize]; the pages are split
+     *        evenly between the shards
+     * @param policyArgs are passed to the eviction policy of every shard
+     */
+    template <typename... PolicyArgs>
+    sharded_cache_mt(index_type cacheSize,
+                     unsigned numShards,
+                     typename traits_type::initializer_type traitsInitializer,
+                     thread_pool *writeBackExecutor = nullptr,
+                     allocator_type const &alloc = allocator_type(),
+                     PolicyArgs &&...policyArgs)
+        : mShards()
+    {
+        numShards = std::clamp<unsigned>(numShards, 1U,
+                                         std::max<unsigned>(cacheSize, 1U));
+        mShards.reserve(numShards);
+        for (unsigned i = 0U; i < numShards; ++i)
+        {
+            auto const shardSize = static_cast<index_type>(
+                    cacheSize / numShards + (i < cacheSize % numShards));
+            mShards.push_back(std::make_unique<shard_type>(
+                    shardSize, traitsInitializer, writeBackExecutor,
+                    allocator_for_shard(alloc, i), policyArgs...));
+        }
+    }
+
+    /**
+     * @brief The number of shards suggested for a cache of the given size,
+     *        i.e. one per hardware thread as long as each shard retains at
+     *        least min_shard_size pages.
+     */
+    static auto suggested_num_shards(std::size_t const cacheSize) noexcept
+            -> unsigned
+    {
+        auto const numThreads
+                = std::max(1U, std::thread::hardware_concurrency());
+        return static_cast<unsigned>(std::clamp<std::size_t>(
+                cacheSize / min_shard_size, 1U, numThreads));
+    }
+
+    auto num_shards() const noexcept -> unsigned
+    {
+        return static_cast<unsigned>(mShards.size());
+    }
+    auto size() const noexcept -> index_type
+    {
+        index_type numPages = 0U;
+        for (auto const &shard : mShards)
+        {
+            numPages += shard->size();
+        }
+        return numPages;
+    }
+
+    /**
+     * @brief Takes a snapshot of the accumulated statistics of all shards.
+     */
+    auto stats() const noexcept -> cache_stats
+    {
+        cache_stats accumulated{};
+        for (auto const &shard : mShards)
+        {
+            accumulated += shard->stats();
+        }
+        return accumulated;
+    }
+
+    auto try_pin(key_type const &key) noexcept -> handle
+    {
+        return shard_of(key).try_pin(key);
+    }
+    auto pin_or_load(load_context const &ctx, key_type const &key) noexcept
+            -> result<handle>
+    {
+        return shard_of(key).pin_or_load(ctx, key);
+    }
+
+    /**
+     * @brief Loads the pages of the given keys which aren't cached yet, see
+     *        cache_mt::load_many(). The keys are grouped by their shard.
+     */
+    auto load_many(load_context const &ctx,
+                   std::span<key_type const> keys) noexcept -> result<void>
+        requires cache_batch_load_traits<Traits>
+    {
+        using boost::container::static_vector;
+
+        static_vector<key_type, Traits::max_batch_size> shardKeys;
+        keys = keys.first(std::min(keys.size(), Traits::max_batch_size));
+        for (auto const &shard : mShards)
+        {
+            shardKeys.clear();
+            for (auto const &key : keys)
+            {
+                if (&shard_of(key) == shard.get())
+                {
+                    shardKeys.push_back(key);
+                }
+            }
+            if (!shardKeys.empty())
+            {
+                VEFS_TRY(shard->load_many(
+                        ctx, std::span<key_type const>(shardKeys)));
+            }
+        }
+        return oc::success();
+    }
+
+    auto purge(purge_context &ctx, key_type const &key) noexcept
+            -> result<void>
+    {
+        return shard_of(key).purge(ctx, key);
+    }
+    auto purge(purge_context &ctx, handle &&which) noexcept -> result<void>
+    {
+        if (!which)
+        {
+            return errc::invalid_argument;
+        }
+        return shard_of(which.key()).purge(ctx, std::move(which));
+    }
+
+    auto sync(handle const &which) noexcept -> result<void>
+    {
+        if (!which)
+        {
+            return oc::success();
+        }
+        return shard_of(which.key()).sync(which);
+    }
+    auto sync_all() noexcept -> result<bool>
+    {
+        return sync_all([](key_type const &) noexcept { return 0; });
+    }
+    /**
+     * @brief Synchronizes all dirty pages in ascending order of their rank
+     *        across all shards, see cache_mt::sync_all().
+     */
+    template <typename RankFn>
+    auto sync_all(RankFn &&rankOf) noexcept -> result<bool>
+    {
+        return sync_all_if([](key_type const &) noexcept { return true; },
+                           rankOf);
+    }
+    /**
+     * @brief Synchronizes the dirty pages whose key satisfies the predicate
+     *        in ascending order of their rank across all shards, i.e. a rank
+     *        is synchronized in every shard before the next one is started.
+     *
+     * @return true if any selected page was dirty
+     */
+    template <typename Predicate, typename RankFn>
+    auto sync_all_if(Predicate &&selects, RankFn &&rankOf) noexcept
+            -> result<bool>
+    {
+        using rank_type = std::remove_cvref_t<
+                std::invoke_result_t<RankFn &, key_type const &>>;
+
+        bool anyDirty = false;
+        std::optional<rank_type> previousRank;
+        for (;;)
+        {
+            std::optional<rank_type> rank;
+            for (auto const &shard : mShards)
+            {
+                if (auto const shardRank
+                    = shard->min_dirty_rank_if(selects, rankOf);
+                    shardRank.has_value()
+                    && (!rank.has_value() || *shardRank < *rank))
+                {
+                    rank = shardRank;
+                }
+            }
+            if (!rank.has_value())
+            {
+                break;
+            }
+            if (previousRank.has_value() && !(*previousRank < *rank))
+            {
+                // the remaining pages have been modified concurrently, i.e.
+                // they are left to the next invocation
+                break;
+            }
+            anyDirty = true;
+
+            auto const selectsRank
+                    = [&selects, &rankOf, &rank](key_type const &key) {
+                          return selects(key) && rankOf(key) == *rank;
+                      };
+            for (auto const &shard : mShards)
+            {
+                VEFS_TRY(shard->sync_all_if(selectsRank, rankOf));
+            }
+            previousRank = rank;
+        }
+        return anyDirty;
+    }
+
+    /**
+     * @brief Synchronizes the cached dirty pages of the given keys, see
+     *        cache_mt::sync_keys(). The keys are reordered by their shard.
+     *
+     * @return true if any given page was dirty
+     */
+    auto sync_keys(std::span<key_type> keys) noexcept -> result<bool>
+    {
+        auto const shardIndexOf = [this](key_type const &key) noexcept {
+            return shard_index_of(key);
+        };
+        std::ranges::sort(keys, {}, shardIndexOf);
+
+        bool anyDirty = false;
+        for (auto it = keys.begin(); it != keys.end();)
+        {
+            auto const shard = shard_index_of(*it);
+            auto const shardEnd = std::ranges::find_if(
+                    it, keys.end(),
+                    [&shardIndexOf, shard](key_type const &key) {
+                        return shardIndexOf(key) != shard;
+                    });
+            VEFS_TRY(auto &&shardDirty,
+                     mShards[shard]->sync_keys(
+                             std::span<key_type const>(it, shardEnd)));
+            anyDirty = anyDirty || shardDirty;
+            it = shardEnd;
+        }
+        return anyDirty;
+    }
+
+    /**
+     * @brief Drops every unpinned page whose key satisfies the predicate
+     *        without synchronizing it, see cache_mt::discard_if().
+     *
+     * @return the number of selected pages which remain pinned
+     */
+    template <typename Predicate>
+    auto discard_if(Predicate &&selects) noexcept -> index_type
+    {
+        index_type numPinned = 0U;
+        for (auto const &shard : mShards)
+        {
+            numPinned += shard->discard_if(selects);
+        }
+        return numPinned;
+    }
+
+    auto write_back() noexcept -> result<unsigned>
+    {
+        unsigned numSynced = 0U;
+        for (auto const &shard : mShards)
+        {
+            VEFS_TRY(auto &&shardSynced, shard->write_back());
+            numSynced += shardSynced;
+        }
+        return numSynced;
+    }
+
+private:
+    // allocators may place the storage of every shard individually, e.g. on
+    // different NUMA nodes
+    static auto allocator_for_shard(allocator_type const &alloc,
+                                    unsigned const shard) -> allocator_type
+    {
+        if constexpr (requires { alloc.for_shard(shard); })
+        {
+            return alloc.for_shard(shard);
+        }
+        else
+        {
+            return alloc;
+        }
+    }
+
+    auto shard_index_of(key_type const &key) const noexcept -> std::size_t
+    {
+        // the upper half of the hash is used, because the lower half selects
+        // the index bucket within the shard
+        auto const h = hash<spooky_v2_hash, std::uint64_t>(key);
+        return hash_to_index(static_cast<std::uint32_t>(h >> 32),
+                             num_shards());
+    }
+    auto shard_of(key_type const &key) noexcept -> shard_type &
+    {
+        return *mShards[shard_index_of(key)];
+    }
+};
+
+} // namespace vefs::detail
@@ -1,12 +1,13 @@
 #pragma once
 
-#include <algorithm>
+#include <cstddef>
+#include <iterator>
 #include <memory>
-#include <ranges>
 #include <span>
 #include <vector>
 
 #include <vefs/cache/cache_page.hpp>
+#include <vefs/cache/index_list.hpp>
 
 namespace vefs::detail
 {
@@ -20,25 +21,33 @@ public:
     using key_type = KeyType;
     using index_type = IndexType;
     using page_state = cache_page_state<KeyType>;
-    using allocator_type = typename std::allocator_traits<
-            Allocator>::template rebind_alloc<index_type>;
-    using list_type = std::vector<index_type, allocator_type>;
+    using list_type = index_list<index_type, Allocator>;
+    using segment_flags_type = std::vector<
+            bool,
+            typename std::allocator_traits<Allocator>::template rebind_alloc<
+                    bool>>;
 
 private:
     page_state *mPages;
+    // the first mNumOnProbation entries are on probation, the remainder is
+    // protected
     list_type mSLRU;
+    segment_flags_type mOnProbation;
+    index_type mProtectedHead;
     std::size_t mNumOnProbation;
     static constexpr std::size_t divider = 5U;
 
 public:
+    // the list is indexed by page, i.e. it doesn't depend on the capacity
     segmented_least_recently_used_policy(std::span<page_state> pages,
-                                         std::size_t capacity,
+                                         [[maybe_unused]] std::size_t capacity,
                                          Allocator const &alloc = Allocator())
         : mPages(pages.data())
-        , mSLRU(alloc)
+        , mSLRU(pages.size(), alloc)
+        , mOnProbation(pages.size(), false, alloc)
+        , mProtectedHead(mSLRU.sentinel())
         , mNumOnProbation{}
     {
-        mSLRU.reserve(capacity);
     }
 
     class replacement_iterator
@@ -46,7 +55,7 @@ public:
         friend class segmented_least_recently_used_policy;
 
         segmented_least_recently_used_policy *mOwner;
-        typename list_type::iterator mHand;
+        index_type mHand;
 
     public:
         constexpr replacement_iterator() noexcept
@@ -62,9 +71,9 @@ public:
 
         explicit replacement_iterator(
                 segmented_least_recently_used_policy &owner,
-                typename list_type::iterator hand) noexcept
+                index_type hand) noexcept
             : mOwner(&owner)
-            , mHand(std::move(hand))
+            , mHand(hand)
         {
         }
 
@@ -76,16 +85,16 @@ public:
 
         auto operator*() const noexcept -> reference
         {
-            return mOwner->mPages[*mHand];
+            return mOwner->mPages[mHand];
         }
         auto operator->() const noexcept -> pointer
         {
-            return mOwner->mPages + *mHand;
+            return mOwner->mPages + mHand;
         }
 
         auto operator++() noexcept -> replacement_iterator &
         {
-            ++mHand;
+            mHand = mOwner->mSLRU.next(mHand);
             return *this;
         }
         auto operator++(int) noexcept -> replacement_iterator
@@ -103,31 +112,48 @@ public:
 
     auto begin() -> replacement_iterator
     {
-        return replacement_iterator{*this, mSLRU.begin()};
+        return replacement_iterator{*this, mSLRU.front()};
     }
     auto end() -> replacement_iterator
     {
-        return replacement_iterator(*this, mSLRU.end());
+        return replacement_iterator(*this, mSLRU.sentinel());
     }
 
     void insert(key_type const &, index_type where) noexcept
     {
-        mSLRU.insert(std::ranges::next(mSLRU.begin(), mNumOnProbation), where);
+        mSLRU.insert_before(mProtectedHead, where);
+        mOnProbation[where] = true;
         mNumOnProbation += 1U;
     }
     auto on_access(key_type const &, index_type where) noexcept -> bool
     {
-        using std::swap;
-        auto const it = std::ranges::find(mSLRU, where);
-        auto const end = mSLRU.end();
-        if (it == end)
+        if (!mSLRU.contains(where))
         {
             return false;
         }
 
-        std::ranges::rotate(it, std::next(it), end);
-        if (mNumOnProbation > mSLRU.size() / divider)
+        // the segment boundary is positional, i.e. an entry moving to the
+        // back makes room for its successor to join the probation segment
+        auto const shrinkProbation
+                = mNumOnProbation > mSLRU.size() / divider;
+        auto const wasOnProbation = static_cast<bool>(mOnProbation[where]);
+        unlink(where);
+        mSLRU.push_back(where);
+        if (mProtectedHead == mSLRU.sentinel())
         {
+            mProtectedHead = where;
+        }
+
+        if (wasOnProbation && !shrinkProbation)
+        {
+            mOnProbation[mProtectedHead] = true;
+            mProtectedHead = mSLRU.next(mProtectedHead);
+            mNumOnProbation += 1U;
+        }
+        else if (!wasOnProbation && shrinkProbation)
+        {
+            mProtectedHead = mSLRU.prev(mProtectedHead);
+            mOnProbation[mProtectedHead] = false;
             mNumOnProbation -= 1U;
         }
         return true;
@@ -141,23 +167,16 @@ public:
         auto const rx = which->try_start_replace(generation);
         if (rx != cache_replacement_result::pinned)
         {
-            where = *which.mHand;
-            mSLRU.erase(which.mHand);
+            where = which.mHand;
+            unlink(which.mHand);
         }
         return rx;
     }
     auto on_purge(key_type const &, index_type where) noexcept -> bool
     {
-        auto const it = std::ranges::find(mSLRU, where);
-        if (it != mSLRU.end())
+        if (mSLRU.contains(where))
         {
-            if (std::ranges::distance(mSLRU.begin(), it)
-                < static_cast<typename list_type::difference_type>(
-                        mNumOnProbation))
-            {
-                mNumOnProbation -= 1U;
-            }
-            mSLRU.erase(it);
+            unlink(where);
             return true;
         }
         else
@@ -165,6 +184,21 @@ public:
             return false;
         }
     }
+
+private:
+    void unlink(index_type const which) noexcept
+    {
+        if (mOnProbation[which])
+        {
+            mOnProbation[which] = false;
+            mNumOnProbation -= 1U;
+        }
+        else if (which == mProtectedHead)
+        {
+            mProtectedHead = mSLRU.next(which);
+        }
+        mSLRU.erase(which);
+    }
 };
 
 } // namespace vefs::detail
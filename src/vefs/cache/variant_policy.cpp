@@ -0,0 +1,6 @@
+#include "vefs/cache/variant_policy.hpp"
+
+namespace vefs::detail
+{
+
+}
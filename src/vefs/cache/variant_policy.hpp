@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cstddef>
+
+#include <concepts>
+#include <iterator>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include <vefs/cache/cache_page.hpp>
+#include <vefs/cache/eviction_policy.hpp>
+
+namespace vefs::detail
+{
+
+/**
+ * @brief An eviction policy which forwards to one of the given policies. The
+ *        policy is selected at runtime by its index within Policies.
+ */
+template <eviction_policy Policy, eviction_policy... Policies>
+class variant_policy
+{
+public:
+    using key_type = typename Policy::key_type;
+    using index_type = typename Policy::index_type;
+    using page_state = cache_page_state<key_type>;
+
+    static_assert((std::same_as<key_type, typename Policies::key_type> && ...));
+    static_assert(
+            (std::same_as<index_type, typename Policies::index_type> && ...));
+
+    static constexpr std::size_t num_policies = 1U + sizeof...(Policies);
+
+private:
+    using policy_variant = std::variant<Policy, Policies...>;
+
+    policy_variant mPolicy;
+
+public:
+    /**
+     * @param which the index of the selected policy; it falls back to the
+     *        first policy if which is out of range
+     */
+    template <typename Allocator>
+    variant_policy(std::span<page_state> const pages,
+                   std::size_t const capacity,
+                   Allocator const &alloc,
+                   std::size_t const which = 0U)
+        : mPolicy(make_policy<0U>(which, pages, capacity, alloc))
+    {
+    }
+
+    class replacement_iterator
+    {
+        friend class variant_policy;
+
+        using hand_variant
+                = std::variant<typename Policy::replacement_iterator,
+                               typename Policies::replacement_iterator...>;
+
+        hand_variant mHand;
+
+        explicit replacement_iterator(hand_variant hand) noexcept
+            : mHand(std::move(hand))
+        {
+        }
+
+    public:
+        constexpr replacement_iterator() noexcept
+            : mHand()
+        {
+        }
+
+        friend inline auto
+        operator==(replacement_iterator const &left,
+                   replacement_iterator const &right) noexcept -> bool
+                = default;
+
+        using difference_type = std::ptrdiff_t;
+        using value_type = page_state;
+        using pointer = page_state *;
+        using reference = page_state &;
+        using iterator_category = std::forward_iterator_tag;
+
+        auto operator*() const noexcept -> reference
+        {
+            return std::visit(
+                    [](auto const &hand) -> reference { return *hand; },
+                    mHand);
+        }
+        auto operator->() const noexcept -> pointer
+        {
+            return std::addressof(operator*());
+        }
+
+        auto operator++() noexcept -> replacement_iterator &
+        {
+            std::visit([](auto &hand) { ++hand; }, mHand);
+            return *this;
+        }
+        auto operator++(int) noexcept -> replacement_iterator
+        {
+            auto old = *this;
+            operator++();
+            return old;
+        }
+    };
+
+private:
+    using hand_variant = typename replacement_iterator::hand_variant;
+
+public:
+    //! the index of the selected policy
+    auto selected() const noexcept -> std::size_t
+    {
+        return mPolicy.index();
+    }
+
+    auto num_managed() const noexcept -> std::size_t
+    {
+        return std::visit(
+                [](auto const &policy) { return policy.num_managed(); },
+                mPolicy);
+    }
+    auto needs_access_replay() const noexcept -> bool
+    {
+        return std::visit(
+                [](auto const &policy) {
+                    return detail::needs_access_replay(policy);
+                },
+                mPolicy);
+    }
+
+    auto begin() -> replacement_iterator
+    {
+        return std::visit(
+                [](auto &policy) {
+                    return replacement_iterator{hand_variant(policy.begin())};
+                },
+                mPolicy);
+    }
+    auto end() -> replacement_iterator
+    {
+        return std::visit(
+                [](auto &policy) {
+                    return replacement_iterator{hand_variant(policy.end())};
+                },
+                mPolicy);
+    }
+
+    void insert(key_type const &key, index_type const where) noexcept
+    {
+        std::visit([&](auto &policy) { policy.insert(key, where); }, mPolicy);
+    }
+    auto on_access(key_type const &key, index_type const where) noexcept -> bool
+    {
+        return std::visit(
+                [&](auto &policy) { return policy.on_access(key, where); },
+                mPolicy);
+    }
+
+    auto try_evict(replacement_iterator &&which,
+                   index_type &where,
+                   typename page_state::state_type &nextGeneration) noexcept
+            -> cache_replacement_result
+    {
+        // the iterator has been obtained from the selected policy, i.e. the
+        // mismatching combinations are never visited
+        return std::visit(
+                [&](auto &policy, auto &&hand) -> cache_replacement_result {
+                    using hand_type = std::remove_cvref_t<decltype(hand)>;
+                    using policy_type = std::remove_cvref_t<decltype(policy)>;
+                    if constexpr (std::same_as<
+                                          hand_type,
+                                          typename policy_type::
+                                                  replacement_iterator>)
+                    {
+                        return policy.try_evict(std::move(hand), where,
+                                                nextGeneration);
+                    }
+                    else
+                    {
+                        return cache_replacement_result::pinned;
+                    }
+                },
+                mPolicy, std::move(which.mHand));
+    }
+    auto on_purge(key_type const &key, index_type const where) noexcept -> bool
+    {
+        return std::visit(
+                [&](auto &policy) { return policy.on_purge(key, where); },
+                mPolicy);
+    }
+
+private:
+    template <std::size_t I, typename Allocator>
+    static auto make_policy(std::size_t const which,
+                            std::span<page_state> const pages,
+                            std::size_t const capacity,
+                            Allocator const &alloc) -> policy_variant
+    {
+        if constexpr (I + 1U < num_policies)
+        {
+            if (which != I)
+            {
+                return make_policy<I + 1U>(which, pages, capacity, alloc);
+            }
+        }
+        else if constexpr (I > 0U)
+        {
+            if (which != I)
+            {
+                return policy_variant(std::in_place_index<0U>, pages, capacity,
+                                      alloc);
+            }
+        }
+        return policy_variant(std::in_place_index<I>, pages, capacity, alloc);
+    }
+};
+
+} // namespace vefs::detail
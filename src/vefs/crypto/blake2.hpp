@@ -132,6 +132,8 @@ public:
     {
         utils::secure_data_erase(mState);
     }
+    blake2xb(blake2xb const &) noexcept = default;
+    auto operator=(blake2xb const &) noexcept -> blake2xb & = default;
 
     result<void> init(std::size_t digestSize) noexcept;
     result<void> init(std::size_t digestSize, ro_dynblob key) noexcept;
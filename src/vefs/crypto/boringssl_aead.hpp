@@ -16,6 +16,7 @@
 
 #include <vefs/disappointment.hpp>
 #include <vefs/exceptions.hpp>
+#include <vefs/platform/secure_memzero.hpp>
 #include <vefs/span.hpp>
 
 namespace vefs::ed
@@ -66,13 +67,14 @@ inline std::size_t nonce_size(const EVP_AEAD *impl)
 
 class boringssl_aead final
 {
-    boringssl_aead() = default;
-
 public:
+    //! constructs an uninitialized context, see rekey()
+    boringssl_aead() noexcept = default;
+
     boringssl_aead(boringssl_aead const &) = delete;
     boringssl_aead(boringssl_aead &&other) noexcept
         : mCtx{other.mCtx}
-        , mInitialized{other.mInitialized}
+        , mInitialized{std::exchange(other.mInitialized, false)}
     {
         memset(&other.mCtx, 0, sizeof(other.mCtx));
     }
@@ -94,17 +96,32 @@ public:
                                          const EVP_AEAD *algorithm
                                          = EVP_aead_aes_256_gcm()) noexcept
     {
-        using namespace std::string_view_literals;
+        boringssl_aead ctx;
+        VEFS_TRY(ctx.rekey(key, algorithm));
+        return ctx;
+    }
+    ~boringssl_aead()
+    {
+        reset();
+    }
 
-        ERR_clear_error();
+    /**
+     * @brief (Re-)Initializes the context in place with the given key, i.e.
+     *        a context can be reused for many keys without being recreated.
+     */
+    auto rekey(ro_dynblob key,
+               const EVP_AEAD *algorithm = EVP_aead_aes_256_gcm()) noexcept
+            -> result<void>
+    {
+        using namespace std::string_view_literals;
 
+        reset();
         if (key.size() != EVP_AEAD_key_length(algorithm))
         {
             return errc::invalid_argument;
         }
 
-        boringssl_aead ctx;
-        if (!EVP_AEAD_CTX_init(&ctx.mCtx, algorithm,
+        if (!EVP_AEAD_CTX_init(&mCtx, algorithm,
                                reinterpret_cast<uint8_t const *>(key.data()),
                                key.size(), EVP_AEAD_DEFAULT_TAG_LENGTH,
                                nullptr))
@@ -113,15 +130,18 @@ public:
                    << ed::error_code_api_origin{"EVP_AEAD_CTX_init"sv}
                    << make_openssl_errinfo();
         }
-        ctx.mInitialized = true;
-        return ctx;
+        mInitialized = true;
+        return outcome::success();
     }
-    ~boringssl_aead()
+    //! releases the context and erases the key schedule
+    void reset() noexcept
     {
+        ERR_clear_error();
         if (mInitialized)
         {
-            ERR_clear_error();
             EVP_AEAD_CTX_cleanup(&mCtx);
+            utils::secure_data_erase(mCtx);
+            mInitialized = false;
         }
     }
 
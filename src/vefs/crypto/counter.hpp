@@ -3,6 +3,7 @@
 #include <cassert>
 #include <climits>
 #include <cstddef>
+#include <cstdint>
 
 #include <atomic>
 #include <bit>
@@ -148,6 +149,42 @@ public:
         mCtrState.value[3] = static_cast<std::uint32_t>(acc);
 #else
 #error "invalid VEFS_COUNTER_IMPL value"
+#endif
+    }
+    //! adds n to the counter
+    inline void advance(std::uint64_t const n) noexcept
+    {
+#if VEFS_COUNTER_IMPL == VEFS_COUNTER_IMPL_INT128
+        mCtrState = std::bit_cast<state>(
+                __extension__ std::bit_cast<unsigned __int128>(mCtrState) + n);
+#elif VEFS_COUNTER_IMPL == VEFS_COUNTER_IMPL_ADC64
+        _addcarry_u64(
+                _addcarry_u64(0U, mCtrState.value[0], n, &mCtrState.value[0]),
+                mCtrState.value[1], 0, &mCtrState.value[1]);
+#elif VEFS_COUNTER_IMPL == VEFS_COUNTER_IMPL_ADC32
+        auto const nLow = static_cast<std::uint32_t>(n);
+        auto const nHigh = static_cast<std::uint32_t>(n >> 32);
+        _addcarry_u32(
+                _addcarry_u32(
+                        _addcarry_u32(_addcarry_u32(0U, mCtrState.value[0],
+                                                    nLow, &mCtrState.value[0]),
+                                      mCtrState.value[1], nHigh,
+                                      &mCtrState.value[1]),
+                        mCtrState.value[2], 0, &mCtrState.value[2]),
+                mCtrState.value[3], 0, &mCtrState.value[3]);
+#elif VEFS_COUNTER_IMPL == VEFS_COUNTER_IMPL_GENERIC
+        constexpr int bitWidth = sizeof(std::uint32_t) * CHAR_BIT;
+        std::uint64_t acc{static_cast<std::uint32_t>(n)};
+        acc += mCtrState.value[0];
+        mCtrState.value[0] = static_cast<std::uint32_t>(acc);
+        acc = mCtrState.value[1] + (n >> bitWidth) + (acc >> bitWidth);
+        mCtrState.value[1] = static_cast<std::uint32_t>(acc);
+        acc = mCtrState.value[2] + (acc >> bitWidth);
+        mCtrState.value[2] = static_cast<std::uint32_t>(acc);
+        acc = mCtrState.value[3] + (acc >> bitWidth);
+        mCtrState.value[3] = static_cast<std::uint32_t>(acc);
+#else
+#error "invalid VEFS_COUNTER_IMPL value"
 #endif
     }
     inline auto operator++() -> counter &
@@ -331,6 +368,52 @@ namespace vefs::crypto
 
 using atomic_counter = std::atomic<counter>;
 
-}
+/**
+ * @brief Hands out blocks of consecutive counter values with a single atomic
+ *        add, i.e. concurrent reservations don't serialize on a lock.
+ *
+ * atomic_counter needs to guard its 128bit state with a spin lock, because a
+ * double word CAS isn't portable. Therefore the values are represented as a
+ * fixed base and a 64bit offset which is the only mutable state.
+ */
+class counter_sequence
+{
+    counter mBase;
+    std::atomic<std::uint64_t> mNext;
+
+public:
+    explicit counter_sequence(counter base) noexcept
+        : mBase(base)
+        , mNext(0U)
+    {
+    }
+
+    counter_sequence(counter_sequence const &) = delete;
+    auto operator=(counter_sequence const &) -> counter_sequence & = delete;
+
+    /**
+     * @brief Reserves num consecutive values.
+     * @return the first reserved value
+     */
+    auto reserve(std::uint64_t const num = 1U) noexcept -> counter
+    {
+        auto const offset = mNext.fetch_add(num, std::memory_order::relaxed);
+        // 2^64 reservations take a couple of centuries at 10^9 per second
+        assert(offset + num >= offset);
+
+        counter first{mBase};
+        first.advance(offset);
+        return first;
+    }
+    //! the value which will be returned by the next reservation
+    auto load() const noexcept -> counter
+    {
+        counter next{mBase};
+        next.advance(mNext.load(std::memory_order::relaxed));
+        return next;
+    }
+};
+
+} // namespace vefs::crypto
 
 DPLX_DP_DECLARE_CODEC_SIMPLE(vefs::crypto::atomic_counter);
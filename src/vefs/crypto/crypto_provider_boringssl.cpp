@@ -11,30 +11,132 @@
 
 namespace vefs::crypto::detail
 {
+namespace
+{
+/**
+ * Every sector is sealed with its own key, i.e. the key schedule needs to be
+ * computed for each box operation. However, the AEAD context itself is reused
+ * by each thread instead of being set up and torn down every time.
+ */
+class aead_lease
+{
+    static thread_local boringssl_aead threadContext;
+
+    boringssl_aead *mAead;
+
+public:
+    aead_lease() noexcept
+        : mAead(&threadContext)
+    {
+    }
+    aead_lease(aead_lease &&other) noexcept
+        : mAead(std::exchange(other.mAead, nullptr))
+    {
+    }
+    auto operator=(aead_lease &&) -> aead_lease & = delete;
+    ~aead_lease()
+    {
+        if (mAead != nullptr)
+        {
+            // don't leave the key schedule behind
+            mAead->reset();
+        }
+    }
+
+    static auto acquire(ro_dynblob key, EVP_AEAD const *algorithm) noexcept
+            -> result<aead_lease>
+    {
+        aead_lease lease;
+        VEFS_TRY(lease.rekey(key, algorithm));
+        return lease;
+    }
+
+    auto rekey(ro_dynblob key, EVP_AEAD const *algorithm) noexcept
+            -> result<void>
+    {
+        return mAead->rekey(key, algorithm);
+    }
+    auto operator->() const noexcept -> boringssl_aead *
+    {
+        return mAead;
+    }
+};
+
+thread_local boringssl_aead aead_lease::threadContext{};
+
+auto evp_aead_of(aead_algorithm algorithm) noexcept -> EVP_AEAD const *
+{
+    switch (algorithm)
+    {
+    case aead_algorithm::chacha20_poly1305:
+        return EVP_aead_chacha20_poly1305();
+    case aead_algorithm::aes_256_gcm_siv:
+        return EVP_aead_aes_256_gcm_siv();
+    case aead_algorithm::aes_256_gcm:
+    default:
+        return EVP_aead_aes_256_gcm();
+    }
+}
+} // namespace
+
 result<void>
-boringssl_aes_256_gcm_provider::box_seal(rw_dynblob ciphertext,
-                                         rw_dynblob mac,
-                                         ro_dynblob keyMaterial,
-                                         ro_dynblob plaintext) const noexcept
+boringssl_aead_provider::box_seal(rw_dynblob ciphertext,
+                                  rw_dynblob mac,
+                                  ro_dynblob keyMaterial,
+                                  ro_dynblob plaintext) const noexcept
 {
-    VEFS_TRY(auto &&aead, boringssl_aead::create(keyMaterial.subspan(0, 32)));
+    VEFS_TRY(auto &&aead, aead_lease::acquire(keyMaterial.subspan(0, 32),
+                                              evp_aead_of(algorithm)));
 
-    return aead.seal(ciphertext, mac, keyMaterial.subspan(32, 12), plaintext);
+    return aead->seal(ciphertext, mac, keyMaterial.subspan(32, 12), plaintext);
 }
 
 result<void>
-boringssl_aes_256_gcm_provider::box_open(rw_dynblob plaintext,
-                                         ro_dynblob keyMaterial,
-                                         ro_dynblob ciphertext,
-                                         ro_dynblob mac) const noexcept
+boringssl_aead_provider::box_open(rw_dynblob plaintext,
+                                  ro_dynblob keyMaterial,
+                                  ro_dynblob ciphertext,
+                                  ro_dynblob mac) const noexcept
 {
-    VEFS_TRY(auto &&aead, boringssl_aead::create(keyMaterial.subspan(0, 32)));
+    VEFS_TRY(auto &&aead, aead_lease::acquire(keyMaterial.subspan(0, 32),
+                                              evp_aead_of(algorithm)));
 
-    return aead.open(plaintext, keyMaterial.subspan(32, 12), ciphertext, mac);
+    return aead->open(plaintext, keyMaterial.subspan(32, 12), ciphertext, mac);
+}
+
+result<void> boringssl_aead_provider::box_seal_batch(
+        std::span<seal_box const> boxes, std::size_t &failedBox) const noexcept
+{
+    // a single lease for the whole batch
+    aead_lease aead{};
+    auto const evpAead = evp_aead_of(algorithm);
+    for (failedBox = 0U; failedBox < boxes.size(); ++failedBox)
+    {
+        auto const &box = boxes[failedBox];
+        auto mac = box.mac;
+        VEFS_TRY(aead.rekey(box.key_material.subspan(0, 32), evpAead));
+        VEFS_TRY(aead->seal(box.ciphertext, mac,
+                            box.key_material.subspan(32, 12), box.plaintext));
+    }
+    return success();
+}
+
+result<void> boringssl_aead_provider::box_open_batch(
+        std::span<open_box const> boxes, std::size_t &failedBox) const noexcept
+{
+    aead_lease aead{};
+    auto const evpAead = evp_aead_of(algorithm);
+    for (failedBox = 0U; failedBox < boxes.size(); ++failedBox)
+    {
+        auto const &box = boxes[failedBox];
+        VEFS_TRY(aead.rekey(box.key_material.subspan(0, 32), evpAead));
+        VEFS_TRY(aead->open(box.plaintext, box.key_material.subspan(32, 12),
+                            box.ciphertext, box.mac));
+    }
+    return success();
 }
 
 vefs::utils::secure_byte_array<16>
-boringssl_aes_256_gcm_provider::generate_session_salt() const
+boringssl_aead_provider::generate_session_salt() const
 {
     using vefs::detail::random_bytes;
     utils::secure_byte_array<16> salt;
@@ -46,14 +148,13 @@ boringssl_aes_256_gcm_provider::generate_session_salt() const
 }
 
 result<void>
-boringssl_aes_256_gcm_provider::random_bytes(rw_dynblob out) const noexcept
+boringssl_aead_provider::random_bytes(rw_dynblob out) const noexcept
 {
     return vefs::detail::random_bytes(out);
 }
 
-result<int>
-boringssl_aes_256_gcm_provider::ct_compare(ro_dynblob l,
-                                           ro_dynblob r) const noexcept
+result<int> boringssl_aead_provider::ct_compare(ro_dynblob l,
+                                                ro_dynblob r) const noexcept
 {
     return ::vefs::crypto::detail::ct_compare(l, r);
 }
@@ -64,10 +165,49 @@ namespace vefs::crypto
 namespace
 {
 detail::boringssl_aes_256_gcm_provider boringssl_aes_256_gcm;
-}
+detail::boringssl_chacha20_poly1305_provider boringssl_chacha20_poly1305;
+detail::boringssl_aes_256_gcm_siv_provider boringssl_aes_256_gcm_siv;
+} // namespace
 
 crypto_provider *boringssl_aes_256_gcm_crypto_provider()
 {
     return &boringssl_aes_256_gcm;
 }
+
+auto boringssl_chacha20_poly1305_crypto_provider() -> crypto_provider *
+{
+    return &boringssl_chacha20_poly1305;
+}
+
+auto boringssl_aes_256_gcm_siv_crypto_provider() -> crypto_provider *
+{
+    return &boringssl_aes_256_gcm_siv;
+}
+
+auto boringssl_preferred_crypto_provider() -> crypto_provider *
+{
+    // without hardware support GCM falls back to a much slower bitsliced
+    // implementation while ChaCha20-Poly1305 is fast on any host
+    if (EVP_has_aes_hardware() != 0)
+    {
+        return &boringssl_aes_256_gcm;
+    }
+    return &boringssl_chacha20_poly1305;
+}
+
+auto boringssl_crypto_provider(aead_algorithm algorithm) -> crypto_provider *
+{
+    switch (algorithm)
+    {
+    case aead_algorithm::aes_256_gcm:
+        return &boringssl_aes_256_gcm;
+    case aead_algorithm::chacha20_poly1305:
+        return &boringssl_chacha20_poly1305;
+    case aead_algorithm::aes_256_gcm_siv:
+        return &boringssl_aes_256_gcm_siv;
+    case aead_algorithm::unspecified:
+    default:
+        return nullptr;
+    }
+}
 } // namespace vefs::crypto
@@ -6,7 +6,11 @@
 
 namespace vefs::crypto::detail
 {
-class boringssl_aes_256_gcm_provider : public crypto_provider
+/**
+ * @brief Boxes data with one of the 256 bit key, 96 bit nonce AEADs offered
+ *        by boringssl, i.e. all of them share the key material layout.
+ */
+class boringssl_aead_provider : public crypto_provider
 {
     result<void> box_seal(rw_dynblob ciphertext,
                           rw_dynblob mac,
@@ -18,6 +22,11 @@ class boringssl_aes_256_gcm_provider : public crypto_provider
                           ro_dynblob ciphertext,
                           ro_dynblob mac) const noexcept override;
 
+    result<void> box_seal_batch(std::span<seal_box const> boxes,
+                                std::size_t &failedBox) const noexcept override;
+    result<void> box_open_batch(std::span<open_box const> boxes,
+                                std::size_t &failedBox) const noexcept override;
+
     utils::secure_byte_array<16> generate_session_salt() const override;
 
     result<void> random_bytes(rw_dynblob out) const noexcept override;
@@ -27,8 +36,37 @@ class boringssl_aes_256_gcm_provider : public crypto_provider
 public:
     static constexpr std::size_t key_material_size = 32 + 12;
 
+    explicit constexpr boringssl_aead_provider(aead_algorithm aead)
+        : crypto_provider(boringssl_aead_provider::key_material_size, aead)
+    {
+    }
+};
+
+class boringssl_aes_256_gcm_provider final : public boringssl_aead_provider
+{
+public:
     constexpr boringssl_aes_256_gcm_provider()
-        : crypto_provider(boringssl_aes_256_gcm_provider::key_material_size)
+        : boringssl_aead_provider(aead_algorithm::aes_256_gcm)
+    {
+    }
+};
+
+class boringssl_chacha20_poly1305_provider final
+    : public boringssl_aead_provider
+{
+public:
+    constexpr boringssl_chacha20_poly1305_provider()
+        : boringssl_aead_provider(aead_algorithm::chacha20_poly1305)
+    {
+    }
+};
+
+class boringssl_aes_256_gcm_siv_provider final
+    : public boringssl_aead_provider
+{
+public:
+    constexpr boringssl_aes_256_gcm_siv_provider()
+        : boringssl_aead_provider(aead_algorithm::aes_256_gcm_siv)
     {
     }
 };
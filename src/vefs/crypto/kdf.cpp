@@ -1,7 +1,5 @@
 #include "kdf.hpp"
 
-#include "blake2.hpp"
-
 namespace vefs::crypto
 {
 
@@ -38,4 +36,32 @@ kdf(rw_dynblob prk, ro_dynblob inputKey, ro_dynblob domain) noexcept
     return state.final(prk);
 }
 
+auto keyed_kdf::init(std::size_t prkSize,
+                     ro_dynblob inputKey,
+                     ro_dynblob domainPrefix) noexcept -> result<void>
+{
+    mPrkSize = 0U;
+    VEFS_TRY(mPrefixState.init(prkSize, inputKey,
+                               detail::vefs_blake2b_personalization_view));
+    VEFS_TRY(mPrefixState.update(domainPrefix));
+    mPrkSize = prkSize;
+    return success();
+}
+
+auto keyed_kdf::derive_impl(rw_dynblob prk,
+                            std::span<ro_dynblob const> domain) const noexcept
+        -> result<void>
+{
+    if (prk.size() != mPrkSize)
+    {
+        return errc::invalid_argument;
+    }
+    detail::blake2xb state{mPrefixState};
+    for (auto &part : domain)
+    {
+        VEFS_TRY(state.update(part));
+    }
+    return state.final(prk);
+}
+
 } // namespace vefs::crypto
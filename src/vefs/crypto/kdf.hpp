@@ -10,6 +10,8 @@
 #include <vefs/span.hpp>
 #include <vefs/utils/secure_array.hpp>
 
+#include "blake2.hpp"
+
 namespace vefs::crypto
 {
 namespace detail
@@ -31,4 +33,43 @@ kdf(rw_dynblob prk, ro_dynblob inputKey, DomainParts const &...parts)
 
     return detail::kdf_impl(prk, inputKey, lparts);
 }
+
+/**
+ * @brief A kdf which has absorbed its input key and a domain prefix once.
+ *
+ * Each derivation starts off a copy of the precomputed state, i.e. it only
+ * absorbs the remaining domain parts. The result equals
+ * kdf(prk, inputKey, domainPrefix, parts...).
+ */
+class keyed_kdf
+{
+public:
+    keyed_kdf() noexcept = default;
+
+    /**
+     * @param prkSize the size of every key derived by this instance
+     */
+    auto init(std::size_t prkSize,
+              ro_dynblob inputKey,
+              ro_dynblob domainPrefix) noexcept -> result<void>;
+
+    template <typename... DomainParts>
+    auto derive(rw_dynblob prk, DomainParts const &...parts) const noexcept
+            -> result<void>
+    {
+        std::array<ro_dynblob, sizeof...(DomainParts)> lparts{
+                as_bytes(std::span(parts))...};
+
+        return derive_impl(prk, lparts);
+    }
+
+private:
+    auto derive_impl(rw_dynblob prk,
+                     std::span<ro_dynblob const> domain) const noexcept
+            -> result<void>;
+
+    detail::blake2xb mPrefixState;
+    // zero until init() succeeded
+    std::size_t mPrkSize = 0U;
+};
 } // namespace vefs::crypto
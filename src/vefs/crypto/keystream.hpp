@@ -0,0 +1,39 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include <openssl/base.h>
+#if !__has_include(<openssl/is_boringssl.h>) || !defined OPENSSL_IS_BORINGSSL
+#error "The keystream uses boringssl specific APIs"
+#endif
+
+#include <openssl/chacha.h>
+
+#include <vefs/span.hpp>
+
+namespace vefs::crypto
+{
+
+/**
+ * @brief Fills out with the ChaCha20 keystream of the given key and nonce.
+ *
+ * The stream is a fast CSPRNG output as long as a key is never used twice
+ * with the same nonce.
+ */
+inline void chacha20_keystream(rw_dynblob out,
+                               ro_blob<32> key,
+                               std::uint64_t nonce) noexcept
+{
+    std::array<std::uint8_t, 12> nonceBytes{};
+    std::memcpy(nonceBytes.data(), &nonce, sizeof(nonce));
+
+    fill_blob(out);
+    auto *const data = reinterpret_cast<std::uint8_t *>(out.data());
+    CRYPTO_chacha_20(data, data, out.size(),
+                     reinterpret_cast<std::uint8_t const *>(key.data()),
+                     nonceBytes.data(), 0U);
+}
+
+} // namespace vefs::crypto
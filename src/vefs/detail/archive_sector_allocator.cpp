@@ -2,6 +2,9 @@
 
 #include <cassert>
 
+#include <algorithm>
+#include <new>
+
 #include <vefs/utils/binary_codec.hpp>
 
 #include "preallocated_tree_allocator.hpp"
@@ -105,6 +108,116 @@ void archive_sector_allocator::dealloc_one(sector_id which,
         on_leak_detected();
     }
 }
+void archive_sector_allocator::dealloc_many(std::span<sector_id> which,
+                                            leak_on_failure_t) noexcept
+{
+    if (which.empty())
+    {
+        return;
+    }
+    std::ranges::sort(which);
+    if (mSectorDevice.discards_free_sectors())
+    {
+        std::lock_guard releaseLock{mReleaseSync};
+        try
+        {
+            mReleasedSectors.insert(mReleasedSectors.end(), which.begin(),
+                                    which.end());
+            return;
+        }
+        catch (std::bad_alloc const &)
+        {
+            // the sectors are simply not discarded
+        }
+    }
+
+    std::lock_guard lock{mAllocatorSync};
+    dealloc_locked(which);
+}
+
+void archive_sector_allocator::seal_released_sectors() noexcept
+{
+    std::lock_guard releaseLock{mReleaseSync};
+    if (mSealedSectors.empty())
+    {
+        mSealedSectors.swap(mReleasedSectors);
+        return;
+    }
+    try
+    {
+        mSealedSectors.insert(mSealedSectors.end(), mReleasedSectors.begin(),
+                              mReleasedSectors.end());
+        mReleasedSectors.clear();
+    }
+    catch (std::bad_alloc const &)
+    {
+        // the released sectors are sealed by the next commit
+    }
+}
+
+void archive_sector_allocator::discard_sealed_sectors() noexcept
+{
+    std::vector<sector_id> sealed;
+    {
+        std::lock_guard releaseLock{mReleaseSync};
+        sealed.swap(mSealedSectors);
+    }
+    if (sealed.empty())
+    {
+        return;
+    }
+    // the sectors can't be reallocated before they are handed back to the
+    // manager, i.e. they can be discarded without holding the lock
+    std::ranges::sort(sealed);
+    discard_runs(sealed);
+
+    std::lock_guard lock{mAllocatorSync};
+    dealloc_locked(sealed);
+}
+
+void archive_sector_allocator::discard_runs(
+        std::span<sector_id const> sorted) noexcept
+{
+    // adjacent sectors are discarded as a single range. reclaiming the
+    // storage is merely an optimization, therefore a failure doesn't affect
+    // the archive
+    for (auto rest = sorted; !rest.empty();)
+    {
+        auto const first = static_cast<std::uint64_t>(rest.front());
+        std::size_t runLength = 1U;
+        while (runLength < rest.size()
+               && static_cast<std::uint64_t>(rest[runLength])
+                          == first + runLength)
+        {
+            ++runLength;
+        }
+        (void)mSectorDevice.discard_sectors(rest.front(), runLength);
+        rest = rest.subspan(runLength);
+    }
+}
+
+void archive_sector_allocator::dealloc_locked(
+        std::span<sector_id const> which) noexcept
+{
+    for (auto const sector : which)
+    {
+        if (!mSectorManager.dealloc_one(sector))
+        {
+            on_leak_detected();
+        }
+    }
+}
+
+auto archive_sector_allocator::discard_free_sectors() noexcept
+        -> result<void>
+{
+    std::lock_guard lock{mAllocatorSync};
+    for (auto const &range : mSectorManager)
+    {
+        VEFS_TRY(mSectorDevice.discard_sectors(range.first(), range.size()));
+    }
+    return success();
+}
 
 auto archive_sector_allocator::merge_from(
         utils::block_manager<sector_id> &other) noexcept -> result<void>
@@ -324,6 +437,15 @@ auto archive_sector_allocator::finalize(
     using file_tree = sector_tree_seq<file_tree_allocator>;
 
     std::lock_guard lock{mAllocatorSync};
+    {
+        // the queued sectors are persisted as free sectors without being
+        // discarded
+        std::lock_guard releaseLock{mReleaseSync};
+        dealloc_locked(mSealedSectors);
+        dealloc_locked(mReleasedSectors);
+        mSealedSectors.clear();
+        mReleasedSectors.clear();
+    }
     VEFS_TRY(trim());
 
     file_tree_allocator::sector_id_container idContainer;
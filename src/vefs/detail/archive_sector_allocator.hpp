@@ -1,6 +1,7 @@
 #pragma once
 
 #include <mutex>
+#include <vector>
 
 #include <vefs/disappointment.hpp>
 #include <vefs/span.hpp>
@@ -36,6 +37,34 @@ public:
 
     auto dealloc_one(sector_id which) noexcept -> result<void>;
     void dealloc_one(sector_id which, leak_on_failure_t) noexcept;
+    /**
+     * Deallocates a batch of sectors. Sorts which in place.
+     *
+     * If the device discards free sectors, the sectors are queued instead,
+     * because the archive header on disk may still reference them. They are
+     * discarded and become allocatable again after the next archive header
+     * has been written, see seal_released_sectors().
+     */
+    void dealloc_many(std::span<sector_id> which, leak_on_failure_t) noexcept;
+
+    /**
+     * Marks the sectors queued by dealloc_many() so far as unreferenced by
+     * the archive index which is about to be committed. Must be called
+     * before the index is synchronized.
+     */
+    void seal_released_sectors() noexcept;
+    /**
+     * Discards the sealed sectors and hands them back to the allocator. Must
+     * be called after the archive header which references the committed
+     * index has been written.
+     */
+    void discard_sealed_sectors() noexcept;
+
+    /**
+     * Discards every currently free sector, see
+     * sector_device::discard_sectors().
+     */
+    auto discard_free_sectors() noexcept -> result<void>;
 
     auto merge_from(utils::block_manager<sector_id> &other) noexcept
             -> result<void>;
@@ -67,11 +96,19 @@ private:
 
     auto trim() noexcept -> result<void>;
 
+    void discard_runs(std::span<sector_id const> sorted) noexcept;
+    void dealloc_locked(std::span<sector_id const> which) noexcept;
+
     sector_device &mSectorDevice;
     utils::block_manager<sector_id> mSectorManager;
     std::mutex mAllocatorSync;
     file_crypto_ctx mFileCtx;
     sector_id mFreeBlockFileRootSector;
     std::atomic<bool> mSectorsLeaked;
+
+    // the sectors which await their discard, see dealloc_many()
+    std::mutex mReleaseSync;
+    std::vector<sector_id> mReleasedSectors;
+    std::vector<sector_id> mSealedSectors;
 };
 } // namespace vefs::detail
@@ -0,0 +1,61 @@
+#include "cache_budget.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace vefs::detail
+{
+
+cache_budget::cache_budget(std::size_t budget,
+                           std::size_t minimumPerCache,
+                           std::size_t pageSize,
+                           bool enforced) noexcept
+    : mMinimumPages(std::clamp<std::size_t>(
+              minimumPerCache / pageSize,
+              // cache_mt starts evicting as soon as less than two pages per
+              // hardware thread are unoccupied
+              min_cache_pages + std::thread::hardware_concurrency() * 2U,
+              max_cache_pages))
+    , mEnforced(enforced)
+    , mAvailablePages(static_cast<std::ptrdiff_t>(
+              std::min<std::size_t>(budget / pageSize, PTRDIFF_MAX)))
+{
+}
+
+auto cache_budget::acquire(std::uint64_t desiredPages) noexcept
+        -> std::uint32_t
+{
+    auto const wanted = static_cast<std::ptrdiff_t>(
+            std::clamp<std::uint64_t>(desiredPages, mMinimumPages,
+                                      max_cache_pages));
+    auto const minimum = static_cast<std::ptrdiff_t>(mMinimumPages);
+
+    std::ptrdiff_t granted;
+    auto available = mAvailablePages.load(std::memory_order::relaxed);
+    do
+    {
+        granted = std::min(wanted, available);
+        if (granted < minimum)
+        {
+            if (mEnforced)
+            {
+                return 0U;
+            }
+            // a soft budget is overcommitted by the minimum, i.e. the
+            // available pages may become negative
+            granted = minimum;
+        }
+    }
+    while (!mAvailablePages.compare_exchange_weak(
+            available, available - granted, std::memory_order::relaxed));
+
+    return static_cast<std::uint32_t>(granted);
+}
+
+void cache_budget::release(std::uint32_t numPages) noexcept
+{
+    mAvailablePages.fetch_add(static_cast<std::ptrdiff_t>(numPages),
+                              std::memory_order::relaxed);
+}
+
+} // namespace vefs::detail
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <atomic>
+
+namespace vefs::detail
+{
+/**
+ * Thread-safe bookkeeping of the memory which the sector caches of all open
+ * vfiles of an archive may occupy.
+ *
+ * Every cache is granted at least a minimum number of pages. Once the
+ * remaining budget can't accommodate that minimum, an enforced budget doesn't
+ * grant any further pages while a soft one still grants the minimum.
+ */
+class cache_budget final
+{
+public:
+    //! the smallest number of pages a cache is granted regardless of the
+    //! configured minimum; each one keeps some pages ready for replacements
+    static constexpr std::size_t min_cache_pages = 64U;
+    static constexpr std::size_t max_cache_pages = UINT32_MAX;
+
+    /**
+     * @param budget the total number of bytes available to all caches
+     * @param minimumPerCache the smallest number of bytes granted to a cache
+     * @param pageSize the number of bytes occupied by a single cache page
+     * @param enforced whether acquire() refuses to exceed the budget
+     */
+    cache_budget(std::size_t budget,
+                 std::size_t minimumPerCache,
+                 std::size_t pageSize,
+                 bool enforced = true) noexcept;
+
+    /**
+     * Reserves memory for a cache which would like to hold desiredPages
+     * pages.
+     *
+     * @return the number of granted pages which need to be returned via
+     *         release() or 0 if an enforced budget is exhausted
+     */
+    auto acquire(std::uint64_t desiredPages) noexcept -> std::uint32_t;
+    void release(std::uint32_t numPages) noexcept;
+
+    auto available() const noexcept -> std::ptrdiff_t
+    {
+        return mAvailablePages.load(std::memory_order::relaxed);
+    }
+
+private:
+    std::size_t mMinimumPages;
+    bool mEnforced;
+    std::atomic<std::ptrdiff_t> mAvailablePages;
+};
+
+} // namespace vefs::detail
@@ -71,11 +71,8 @@ public:
         {
             on_leak_detected();
         }
-        for (auto allocation : mAllocationBuffer)
-        {
-            mSourceAllocator.dealloc_one(
-                    allocation, source_allocator_type::leak_on_failure);
-        }
+        mSourceAllocator.dealloc_many(mAllocationBuffer,
+                                      source_allocator_type::leak_on_failure);
     }
 
     auto reallocate(sector_allocator &forWhich) noexcept -> result<sector_id>
@@ -156,26 +153,28 @@ public:
     auto on_commit() noexcept -> result<void>
     {
         mCommitCounter += 1;
-        std::scoped_lock const lock{mBufferSync, mDeallocationSync};
-
-        auto const bufferAmount = std::min(mAllocationBuffer.capacity()
-                                                   - mAllocationBuffer.size(),
-                                           mOverwrittenAllocations.size());
-        auto const split
-                = std::next(mOverwrittenAllocations.begin(), bufferAmount);
-
-        std::copy(mOverwrittenAllocations.begin(), split,
-                  std::back_inserter(mAllocationBuffer));
-
-        std::for_each(split, mOverwrittenAllocations.end(),
-                      [this](sector_id allocation) {
-                          mSourceAllocator.dealloc_one(
-                                  allocation,
-                                  source_allocator_type::leak_on_failure);
-                      });
-
-        mOverwrittenAllocations.clear();
-        mOverwrittenAllocations.shrink_to_fit();
+        overwritten_id_container_type released;
+        {
+            std::scoped_lock const lock{mBufferSync, mDeallocationSync};
+
+            auto const bufferAmount
+                    = std::min(mAllocationBuffer.capacity()
+                                       - mAllocationBuffer.size(),
+                               mOverwrittenAllocations.size());
+            auto const split
+                    = std::next(mOverwrittenAllocations.begin(), bufferAmount);
+
+            std::copy(mOverwrittenAllocations.begin(), split,
+                      std::back_inserter(mAllocationBuffer));
+
+            // the surplus is returned to the source allocator after the
+            // locks have been released, because it may discard the sectors
+            mOverwrittenAllocations.erase(mOverwrittenAllocations.begin(),
+                                          split);
+            released.swap(mOverwrittenAllocations);
+        }
+        mSourceAllocator.dealloc_many(released,
+                                      source_allocator_type::leak_on_failure);
 
         return success();
     }
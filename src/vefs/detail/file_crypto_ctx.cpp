@@ -18,17 +18,37 @@ constexpr auto sector_kdf_prk = byte_literal(u8"vefs/prk/SectorPRK");
 } // namespace
 
 file_crypto_ctx::file_crypto_ctx(zero_init_t)
-    : mState{}
-    , mStateSync()
+    : mSecret{}
+    , mCounter(crypto::counter{})
+    , mSectorKdf()
 {
+    init_sector_kdf();
 }
 
 file_crypto_ctx::file_crypto_ctx(ro_blob<32> secretView,
                                  crypto::counter secretCounter)
-    : mState{.secret = {}, .counter = secretCounter}
-    , mStateSync()
+    : mSecret{}
+    , mCounter(secretCounter)
+    , mSectorKdf()
 {
-    vefs::copy(secretView, std::span(mState.secret));
+    vefs::copy(secretView, std::span(mSecret));
+    init_sector_kdf();
+}
+
+file_crypto_ctx::file_crypto_ctx(state_type const &state)
+    : mSecret(state.secret)
+    , mCounter(state.counter)
+    , mSectorKdf()
+{
+    init_sector_kdf();
+}
+
+void file_crypto_ctx::init_sector_kdf() noexcept
+{
+    // the sizes are fixed, i.e. this can't fail; if it did anyway every
+    // derivation would fail with invalid_argument
+    (void)mSectorKdf.init(sector_key_nonce::static_size, as_span(mSecret),
+                          as_bytes(sector_kdf_prk));
 }
 
 auto file_crypto_ctx::seal_sector(rw_blob<1 << 15> ciphertext,
@@ -38,20 +58,10 @@ auto file_crypto_ctx::seal_sector(rw_blob<1 << 15> ciphertext,
                                   ro_blob<(1 << 15) - (1 << 5)> data) noexcept
         -> result<void>
 {
-    utils::secure_byte_array<44> sectorKeyNonce;
-    {
-        std::lock_guard stateLock{mStateSync};
-
-        // #TODO constant extraction
-        auto const salt = ciphertext.first<32>();
-        auto const nonce = mState.counter.value();
-        mState.counter.increment();
-        VEFS_TRY(crypto::kdf(salt, as_bytes(as_span(nonce)),
-                             as_bytes(sector_kdf_salt), sessionSalt));
-
-        VEFS_TRY(crypto::kdf(as_span(sectorKeyNonce), as_span(mState.secret),
-                             as_bytes(sector_kdf_prk), salt));
-    }
+    // #TODO constant extraction
+    sector_key_nonce sectorKeyNonce;
+    VEFS_TRY(derive_seal_key(ciphertext.first<32>(), sectorKeyNonce,
+                             sessionSalt));
 
     return provider.box_seal(ciphertext.subspan<32>(), mac,
                              as_span(sectorKeyNonce), data);
@@ -63,13 +73,28 @@ auto file_crypto_ctx::unseal_sector(rw_blob<(1 << 15) - (1 << 5)> data,
         -> result<void>
 {
     // #TODO constant extraction
-    auto const salt = ciphertext.first<32>();
-
-    utils::secure_byte_array<44> sectorKeyNonce;
-    VEFS_TRY(crypto::kdf(as_span(sectorKeyNonce), as_span(mState.secret),
-                         as_bytes(sector_kdf_prk), salt));
+    sector_key_nonce sectorKeyNonce;
+    VEFS_TRY(derive_open_key(sectorKeyNonce, ciphertext.first<32>()));
 
     return provider.box_open(data, as_span(sectorKeyNonce),
                              ciphertext.subspan<32>(), mac);
 }
+
+auto file_crypto_ctx::derive_seal_key(rw_blob<32> salt,
+                                      sector_key_nonce &keyNonce,
+                                      ro_blob<16> sessionSalt) noexcept
+        -> result<void>
+{
+    auto const nonce = mCounter.reserve();
+    VEFS_TRY(crypto::kdf(salt, as_bytes(as_span(nonce.value())),
+                         as_bytes(sector_kdf_salt), sessionSalt));
+
+    return mSectorKdf.derive(as_span(keyNonce), salt);
+}
+auto file_crypto_ctx::derive_open_key(sector_key_nonce &keyNonce,
+                                      ro_blob<32> salt) const noexcept
+        -> result<void>
+{
+    return mSectorKdf.derive(as_span(keyNonce), salt);
+}
 } // namespace vefs::detail
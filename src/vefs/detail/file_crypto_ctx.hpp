@@ -1,7 +1,6 @@
 #pragma once
 
 #include <cstddef>
-#include <mutex>
 
 #include <vefs/crypto/provider.hpp>
 #include <vefs/disappointment.hpp>
@@ -9,6 +8,7 @@
 #include <vefs/utils/secure_array.hpp>
 
 #include "../crypto/counter.hpp"
+#include "../crypto/kdf.hpp"
 
 namespace vefs::detail
 {
@@ -46,11 +46,7 @@ public:
 
     file_crypto_ctx(zero_init_t);
     file_crypto_ctx(ro_blob<32> secretView, crypto::counter secretCounter);
-    explicit file_crypto_ctx(state_type const &state)
-        : mState(state)
-        , mStateSync()
-    {
-    }
+    explicit file_crypto_ctx(state_type const &state);
 
     auto state() const noexcept -> state_type;
 
@@ -66,15 +62,34 @@ public:
                        ro_blob<1 << 15> ciphertext,
                        ro_blob<16> mac) const noexcept -> result<void>;
 
+    //! the key material of a single sector box
+    using sector_key_nonce = utils::secure_byte_array<44>;
+
+    /**
+     * Reserves a nonce and derives the salt which precedes the sector
+     * ciphertext and the key material the sector is sealed with, i.e. it is
+     * seal_sector() without the encryption.
+     */
+    auto derive_seal_key(rw_blob<32> salt,
+                         sector_key_nonce &keyNonce,
+                         ro_blob<16> sessionSalt) noexcept -> result<void>;
+    //! derives the key material a sector has been sealed with from its salt
+    auto derive_open_key(sector_key_nonce &keyNonce,
+                         ro_blob<32> salt) const noexcept -> result<void>;
+
 private:
-    state_type mState;
-    mutable std::mutex mStateSync;
+    void init_sector_kdf() noexcept;
+
+    utils::secure_byte_array<32> mSecret;
+    // concurrent sealers reserve their nonces without locking
+    crypto::counter_sequence mCounter;
+    // keyed with mSecret, derives the sector key and nonce
+    crypto::keyed_kdf mSectorKdf;
 };
 
 inline auto detail::file_crypto_ctx::state() const noexcept -> state_type
 {
-    std::lock_guard lock(mStateSync);
-    return mState;
+    return {.secret = mSecret, .counter = mCounter.load()};
 }
 
 } // namespace vefs::detail
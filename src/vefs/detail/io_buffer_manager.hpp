@@ -191,6 +191,15 @@ public:
         }
     }
 
+    /**
+     * @brief The contiguous memory region backing all preallocated buffers,
+     * e.g. for registering it with the kernel.
+     */
+    auto preallocated_region() const noexcept -> std::span<std::byte>
+    {
+        return mAllocatedPages.as_span();
+    }
+
 private:
     auto head() const noexcept -> control_head &
     {
@@ -1,9 +1,13 @@
 #include "sector_device.hpp"
 
+#include <algorithm>
 #include <array>
+#include <concepts>
+#include <future>
 #include <optional>
 #include <random>
 #include <span>
+#include <system_error>
 
 #include <dplx/dp.hpp>
 #include <dplx/dp/api.hpp>
@@ -24,6 +28,7 @@
 
 #include "../crypto/cbor_box.hpp"
 #include "../crypto/kdf.hpp"
+#include "../crypto/keystream.hpp"
 #include "../platform/sysrandom.hpp"
 #include "archive_file_id.hpp"
 #include "io_buffer_manager.hpp"
@@ -33,16 +38,26 @@ class dplx::dp::codec<vefs::detail::master_header>
 {
     using master_header = vefs::detail::master_header;
 
+    // archives sealed with the default AEAD (or a custom provider) keep the
+    // version 0 layout, i.e. they can still be opened by older readers
+    static auto version_of(master_header const &value) noexcept -> unsigned
+    {
+        using enum vefs::crypto::aead_algorithm;
+        return value.aead == unspecified || value.aead == aes_256_gcm ? 0U
+                                                                      : 1U;
+    }
+
 public:
     static auto decode(parse_context &ctx, master_header &value) noexcept
             -> result<void>
     {
         DPLX_TRY(auto headerHead, dp::decode_tuple_head(ctx, std::true_type{}));
-        if (headerHead.version != 0)
+        // version 0 predates the aead record
+        if (headerHead.version > 1)
         {
             return errc::item_version_mismatch;
         }
-        if (headerHead.num_properties != 2)
+        if (headerHead.num_properties != 2 + headerHead.version)
         {
             return errc::tuple_size_mismatch;
         }
@@ -52,27 +67,47 @@ public:
         DPLX_TRY(ctx.in.bulk_read(value.master_secret.data(),
                                   value.master_secret.size()));
 
-        return dp::decode(ctx, value.master_counter);
+        DPLX_TRY(dp::decode(ctx, value.master_counter));
+
+        std::uint8_t aead = 0U;
+        if (headerHead.version > 0)
+        {
+            DPLX_TRY(dp::decode(ctx, aead));
+        }
+        value.aead = static_cast<vefs::crypto::aead_algorithm>(aead);
+        return oc::success();
     }
     static auto size_of(emit_context &ctx, master_header const &value) noexcept
             -> std::uint64_t
     {
-        return dp::encoded_item_head_size<type_code::array>(3U)
-               + dp::item_size_of_integer(ctx, 0U)
+        auto const version = version_of(value);
+        return dp::encoded_item_head_size<type_code::array>(3U + version)
+               + dp::item_size_of_integer(ctx, version)
                + dp::encoded_size_of(ctx, value.master_secret)
-               + dp::item_size_of_binary(ctx,
-                                         vefs::crypto::counter::state_size);
+               + dp::item_size_of_binary(ctx, vefs::crypto::counter::state_size)
+               + (version > 0U ? dp::item_size_of_integer(
+                                         ctx, static_cast<std::uint8_t>(
+                                                      value.aead))
+                               : 0U);
     }
     static auto encode(emit_context &ctx, master_header const &value) noexcept
             -> result<void>
     {
-        DPLX_TRY(dp::emit_array(ctx, 3U));
-        DPLX_TRY(dp::emit_integer(ctx, 0U)); // version prop
+        auto const version = version_of(value);
+        DPLX_TRY(dp::emit_array(ctx, 3U + version));
+        DPLX_TRY(dp::emit_integer(ctx, version)); // version prop
 
         DPLX_TRY(dp::encode(ctx, value.master_secret));
 
         auto const counter = value.master_counter.load();
-        return dp::encode(ctx, counter.view());
+        DPLX_TRY(dp::encode(ctx, counter.view()));
+
+        if (version > 0U)
+        {
+            DPLX_TRY(dp::emit_integer(ctx,
+                                      static_cast<std::uint8_t>(value.aead)));
+        }
+        return oc::success();
     }
 };
 
@@ -126,6 +161,36 @@ auto const sector_kdf_prk = byte_literal("vefs/prk/SectorPRK");
 auto const file_kdf_secret = byte_literal("vefs/seed/FileSecret");
 auto const file_kdf_counter = byte_literal("vefs/seed/FileSecretCounter");
 
+auto is_addressable_sector(sector_id const sectorIdx) noexcept -> bool
+{
+    constexpr auto sectorIdxLimit = std::numeric_limits<std::uint64_t>::max()
+                                    / sector_device::sector_size;
+    return sectorIdx != sector_id::master
+           && static_cast<std::uint64_t>(sectorIdx) < sectorIdxLimit;
+}
+
+/**
+ * computes the number of leading requests which address physically
+ * consecutive sectors and therefore can be served by one vectored i/o op
+ */
+template <typename Request>
+auto coalescable_prefix_size(std::span<Request const> requests) noexcept
+        -> std::size_t
+{
+    auto const first = static_cast<std::uint64_t>(requests.front().sector);
+    auto const limit
+            = std::min(requests.size(), sector_device::max_vectored_sectors);
+
+    std::size_t runLength = 1U;
+    while (runLength < limit
+           && static_cast<std::uint64_t>(requests[runLength].sector)
+                      == first + runLength)
+    {
+        ++runLength;
+    }
+    return runLength;
+}
+
 } // namespace
 
 auto sector_device::create_file_secrets() noexcept
@@ -174,17 +239,71 @@ auto sector_device::create_file_secrets2() noexcept
 sector_device::sector_device(llfio::file_handle file,
                              crypto::crypto_provider *cryptoProvider,
                              size_t const numSectors)
-    : mCryptoProvider(cryptoProvider)
+    : mStaticHeaderCrypto(
+            cryptoProvider->algorithm == crypto::aead_algorithm::unspecified
+                    ? cryptoProvider
+                    : crypto::boringssl_aes_256_gcm_crypto_provider())
+    , mCryptoProvider(cryptoProvider)
     , mArchiveFile(std::move(file))
     , mArchiveFileLock(mArchiveFile, llfio::lock_kind::unlocked)
     , mSessionSalt(cryptoProvider->generate_session_salt())
+    , mEraseKey()
     , mNumSectors(numSectors)
 {
+    // the sizes are fixed, i.e. this can't fail
+    (void)crypto::kdf(as_span(mEraseKey), mSessionSalt, sector_kdf_erase);
+}
+
+auto sector_device::initialize_io_engine(io_engine const ioEngine) noexcept
+        -> result<void>
+{
+    if (ioEngine != io_engine::io_uring)
+    {
+        return oc::success();
+    }
+    VEFS_TRY(mIoQueue, io_uring_queue::create(
+                               mArchiveFile.native_handle().fd, io_queue_depth,
+                               mIoBufferManager.preallocated_region()));
+    return oc::success();
+}
+
+auto sector_device::read_raw(llfio::file_handle::buffers_type const buffers,
+                             std::uint64_t const offset) noexcept
+        -> result<llfio::file_handle::buffers_type>
+{
+    if (mIoQueue)
+    {
+        VEFS_TRY(mIoQueue->read(buffers, offset));
+        return buffers;
+    }
+    VEFS_TRY(auto &&filled, mArchiveFile.read({buffers, offset}));
+
+    // llfio truncates the buffers at the end of file while the io_uring
+    // engine fails, i.e. both engines report a short read the same way
+    auto const sizeOf = [](auto const &buffer) { return buffer.size(); };
+    if (!std::ranges::equal(filled, buffers, {}, sizeOf, sizeOf))
+    {
+        return archive_errc::sector_reference_out_of_range;
+    }
+    return filled;
+}
+
+auto sector_device::write_raw(
+        llfio::file_handle::const_buffers_type const buffers,
+        std::uint64_t const offset) noexcept -> result<void>
+{
+    if (mIoQueue)
+    {
+        return mIoQueue->write(buffers, offset);
+    }
+    VEFS_TRY(mArchiveFile.write({buffers, offset}));
+    return oc::success();
 }
 
 auto sector_device::open_existing(llfio::file_handle fileHandle,
                                   crypto::crypto_provider *cryptoProvider,
-                                  ro_blob<32> userPRK) noexcept
+                                  ro_blob<32> userPRK,
+                                  io_engine const ioEngine) noexcept
         -> result<open_info>
 {
     VEFS_TRY(auto &&max_extent, fileHandle.maximum_extent());
@@ -210,6 +329,7 @@ auto sector_device::open_existing(llfio::file_handle fileHandle,
     VEFS_TRY(archive->mIoBufferManager,
              io_buffer_manager::create(
                      sector_size, std::thread::hardware_concurrency() * 2U));
+    VEFS_TRY(archive->initialize_io_engine(ioEngine));
     VEFS_TRY(archive->mMasterSector.resize(sector_size));
     auto const buffer = archive->mMasterSector.as_span();
     llfio::byte_io_handle::buffer_type masterSectorBuffer[] = {buffer};
@@ -251,7 +371,8 @@ auto sector_device::open_existing(llfio::file_handle fileHandle,
 
 auto sector_device::create_new(llfio::file_handle fileHandle,
                                crypto::crypto_provider *cryptoProvider,
-                               ro_blob<32> userPRK) noexcept
+                               ro_blob<32> userPRK,
+                               io_engine const ioEngine) noexcept
         -> result<open_info>
 {
     std::unique_ptr<sector_device> archive{new (std::nothrow) sector_device(
@@ -269,6 +390,7 @@ auto sector_device::create_new(llfio::file_handle fileHandle,
     VEFS_TRY(archive->mIoBufferManager,
              io_buffer_manager::create(
                      sector_size, std::thread::hardware_concurrency() * 2U));
+    VEFS_TRY(archive->initialize_io_engine(ioEngine));
     VEFS_TRY(archive->mMasterSector.resize(sector_size));
 
     VEFS_TRY(archive->resize(1));
@@ -280,6 +402,7 @@ auto sector_device::create_new(llfio::file_handle fileHandle,
     VEFS_TRY(cryptoProvider->random_bytes(
             as_writable_bytes(as_span(counterState))));
     archive->mStaticHeader.master_counter.store(crypto::counter(counterState));
+    archive->mStaticHeader.aead = cryptoProvider->algorithm;
 
     std::memset(archive->mMasterSector.as_span().data(), 0, sector_size);
 
@@ -327,8 +450,10 @@ result<void> sector_device::parse_static_archive_header(ro_blob<32> userPRK)
     auto const staticHeader
             = mstream.remaining().first(staticHeaderBox.dataLength);
 
-    if (auto rx = mCryptoProvider->box_open(staticHeader, as_span(keyNonce),
-                                            staticHeader, staticHeaderBox.mac);
+    if (auto rx = mStaticHeaderCrypto->box_open(staticHeader,
+                                                as_span(keyNonce),
+                                                staticHeader,
+                                                staticHeaderBox.mac);
         rx.has_failure())
     {
         if (rx.has_error() && rx.assume_error() == archive_errc::tag_mismatch)
@@ -346,6 +471,28 @@ result<void> sector_device::parse_static_archive_header(ro_blob<32> userPRK)
     dplx::dp::memory_view staticHeaderStream(staticHeader);
 
     VEFS_TRY(dplx::dp::decode(staticHeaderStream, mStaticHeader));
+    return adopt_recorded_aead();
+}
+
+auto sector_device::adopt_recorded_aead() noexcept -> result<void>
+{
+    if (mCryptoProvider->algorithm == crypto::aead_algorithm::unspecified)
+    {
+        // custom providers are used as is
+        return success();
+    }
+    if (mStaticHeader.aead == crypto::aead_algorithm::unspecified)
+    {
+        // archives predating the record have been sealed with AES-256-GCM
+        mStaticHeader.aead = crypto::aead_algorithm::aes_256_gcm;
+    }
+    auto *const recorded
+            = crypto::boringssl_crypto_provider(mStaticHeader.aead);
+    if (recorded == nullptr)
+    {
+        return errc::not_supported;
+    }
+    mCryptoProvider = recorded;
     return success();
 }
 
@@ -399,6 +546,11 @@ auto sector_device::parse_archive_header(header_id which)
     {
         return archive_errc::oversized_static_header;
     }
+    if (headerBox.dataLength == 0)
+    {
+        // the AEAD rejects empty ciphertexts as a precondition violation
+        return archive_errc::no_archive_header;
+    }
 
     secure_byte_array<44> keyNonce;
     VEFS_TRY(crypto::kdf(as_span(keyNonce), master_secret_view(),
@@ -421,11 +573,68 @@ auto sector_device::parse_archive_header(header_id which)
     return header;
 }
 
+void sector_device::warm_up_index_roots(archive_header const &header) noexcept
+{
+    auto bufferrx = mIoBufferManager.allocate();
+    if (!bufferrx)
+    {
+        return;
+    }
+    auto const buffer = bufferrx.assume_value();
+    VEFS_SCOPE_EXIT
+    {
+        mIoBufferManager.deallocate(buffer);
+    };
+
+    for (auto const *index : {&header.filesystem_index,
+                              &header.free_sector_index})
+    {
+        auto const root = index->data.root.sector;
+        if (root == sector_id::master
+            || static_cast<std::uint64_t>(root) >= size())
+        {
+            continue;
+        }
+        llfio::file_handle::buffer_type buffers[] = {
+                {buffer.data(), sector_size}
+        };
+        // the content is discarded, only the page cache is warmed up
+        (void)read_raw(buffers, to_offset(root));
+    }
+}
+
 auto sector_device::parse_archive_header() -> result<archive_header>
 {
+    // the archive headers are decrypted concurrently; as soon as one of them
+    // is available the root sectors of the indices it references are read,
+    // i.e. the index reads following the open overlap with the decryption
+    // of the other header
+    auto const parseAndWarmUp = [this](header_id const which) {
+        auto headerrx = parse_archive_header(which);
+        if (headerrx.has_value())
+        {
+            warm_up_index_roots(headerrx.assume_value());
+        }
+        return headerrx;
+    };
+
+    // the helper thread is owned by this function: the future of
+    // std::async joins it on every exit path, including exceptions
+    std::future<result<archive_header>> secondHeader;
+    try
+    {
+        secondHeader = std::async(std::launch::async, parseAndWarmUp,
+                                  header_id::second);
+    }
+    catch (std::system_error const &)
+    {
+        // no thread available, the second header is parsed afterwards
+    }
+
     result<archive_header> header[2]
-            = {parse_archive_header(header_id::first),
-               parse_archive_header(header_id::second)};
+            = {parseAndWarmUp(header_id::first),
+               secondHeader.valid() ? secondHeader.get()
+                                    : parseAndWarmUp(header_id::second)};
 
     int selector;
     // determine which header to apply
@@ -508,7 +717,7 @@ result<void> sector_device::write_static_archive_header(ro_blob<32> userPRK)
     secure_byte_array<44> key;
     VEFS_TRY(crypto::kdf(as_span(key), userPRK, boxHead.salt));
 
-    VEFS_TRY(mCryptoProvider->box_seal(
+    VEFS_TRY(mStaticHeaderCrypto->box_seal(
             rw_dynblob(staticHeaderSectors.consume(encoded.size()),
                        encoded.size()),
             boxHead.mac, key, encoded));
@@ -557,27 +766,33 @@ auto sector_device::read_sector(rw_blob<sector_payload_size> contentDest,
         return errc::invalid_argument;
     }
 
-    VEFS_TRY(auto ioBuffer, mIoBufferManager.allocate());
-    utils::scope_guard deallocationGuard = [&] {
-        mIoBufferManager.deallocate(ioBuffer);
-    };
-
+    // the ciphertext is read directly into the destination and decrypted in
+    // place, only the salt needs a separate buffer
+    std::array<std::byte, 32> salt;
     auto const sectorOffset = to_offset(sectorIdx);
-    io_buffer reqBuffers[] = {ioBuffer};
+    io_buffer reqBuffers[] = {
+            {       salt.data(),        salt.size()},
+            {contentDest.data(), contentDest.size()}
+    };
 
-    if (auto readrx = mArchiveFile.read({reqBuffers, sectorOffset}))
+    if (auto readrx = read_raw(reqBuffers, sectorOffset))
     {
         auto const buffers = readrx.assume_value();
-        assert(buffers.size() == 1U);
-        assert(buffers[0].size() == sector_size);
-        assert(buffers[0].data() != nullptr);
-
-        VEFS_TRY_INJECT(
-                fileCtx.unseal_sector(
-                        contentDest, *mCryptoProvider,
-                        std::span<std::byte const, sector_size>(buffers[0]),
-                        contentMAC),
-                ed::sector_idx{sectorIdx});
+        assert(buffers.size() == 2U);
+        assert(buffers[0].size() == salt.size());
+        assert(buffers[1].size() == sector_payload_size);
+
+        file_crypto_ctx::sector_key_nonce keyNonce;
+        VEFS_TRY_INJECT(fileCtx.derive_open_key(
+                                keyNonce,
+                                std::span<std::byte const, 32>(buffers[0])),
+                        ed::sector_idx{sectorIdx});
+        VEFS_TRY_INJECT(mCryptoProvider->box_open(
+                                contentDest, as_span(keyNonce),
+                                ro_dynblob(buffers[1].data(),
+                                           buffers[1].size()),
+                                contentMAC),
+                        ed::sector_idx{sectorIdx});
         return oc::success();
     }
     else
@@ -619,35 +834,297 @@ auto sector_device::write_sector(
     auto const sectorOffset = to_offset(sectorIdx);
     llfio::file_handle::const_buffer_type reqBuffers[] = {ioBuffer};
 
-    VEFS_TRY_INJECT(mArchiveFile.write({reqBuffers, sectorOffset}),
+    VEFS_TRY_INJECT(write_raw(reqBuffers, sectorOffset),
                     ed::sector_idx{sectorIdx});
 
     return oc::success();
 }
 
+auto sector_device::read_sectors(
+        std::span<read_request const> requests) noexcept -> result<void>
+{
+    using io_buffer = llfio::file_handle::buffer_type;
+
+    for (auto const &request : requests)
+    {
+        if (!is_addressable_sector(request.sector)
+            || request.crypto_ctx == nullptr)
+        {
+            return errc::invalid_argument;
+        }
+    }
+
+    // like read_sector() every sector is scattered into its salt and its
+    // destination, i.e. the whole run is decrypted in place
+    std::array<std::array<std::byte, 32>, max_vectored_sectors> salts;
+
+    while (!requests.empty())
+    {
+        auto const runLength = coalescable_prefix_size(requests);
+        auto const run = requests.first(runLength);
+        requests = requests.subspan(runLength);
+
+        std::array<io_buffer, 2 * max_vectored_sectors> reqBuffers{};
+        for (std::size_t i = 0U; i < runLength; ++i)
+        {
+            reqBuffers[2 * i] = {salts[i].data(), salts[i].size()};
+            reqBuffers[2 * i + 1]
+                    = {run[i].content.data(), run[i].content.size()};
+        }
+
+        auto const firstSectorIdx = run.front().sector;
+        auto readrx = read_raw(std::span(reqBuffers).first(2 * runLength),
+                               to_offset(firstSectorIdx));
+        if (!readrx)
+        {
+            result<void> adaptedrx{std::move(readrx).as_failure()};
+            adaptedrx.assume_error() << ed::sector_idx{firstSectorIdx};
+            return adaptedrx;
+        }
+
+        auto const buffers = readrx.assume_value();
+        assert(buffers.size() == 2 * runLength);
+
+        // the whole run is decrypted with a single provider call
+        std::array<file_crypto_ctx::sector_key_nonce, max_vectored_sectors>
+                keyNonces;
+        std::array<crypto::open_box, max_vectored_sectors> boxes{};
+        for (std::size_t i = 0U; i < runLength; ++i)
+        {
+            auto const salt = buffers[2 * i];
+            auto const ciphertext = buffers[2 * i + 1];
+            assert(salt.size() == salts[i].size());
+            assert(ciphertext.size() == sector_payload_size);
+
+            VEFS_TRY_INJECT(run[i].crypto_ctx->derive_open_key(
+                                    keyNonces[i],
+                                    std::span<std::byte const, 32>(salt)),
+                            ed::sector_idx{run[i].sector});
+            boxes[i] = {
+                    .plaintext = run[i].content,
+                    .key_material = as_span(keyNonces[i]),
+                    .ciphertext = {ciphertext.data(), ciphertext.size()},
+                    .mac = run[i].mac,
+            };
+        }
+        std::size_t failedBox = 0U;
+        if (auto openrx = mCryptoProvider->box_open_batch(
+                    std::span(boxes).first(runLength), failedBox);
+            openrx.has_failure())
+        {
+            result<void> adaptedrx{std::move(openrx).as_failure()};
+            adaptedrx.assume_error() << ed::sector_idx{run[failedBox].sector};
+            return adaptedrx;
+        }
+    }
+    return oc::success();
+}
+
+template <typename file_crypto_ctx_T>
+auto sector_device::write_sectors(
+        std::span<write_request<file_crypto_ctx_T> const> requests) noexcept
+        -> result<void>
+{
+    using io_buffer = llfio::file_handle::const_buffer_type;
+
+    for (auto const &request : requests)
+    {
+        if (!is_addressable_sector(request.sector)
+            || request.crypto_ctx == nullptr)
+        {
+            return errc::invalid_argument;
+        }
+    }
+
+    // the io buffers are reused for every coalesced run
+    std::array<std::span<std::byte>, max_vectored_sectors> ioBuffers{};
+    std::size_t numIoBuffers = 0U;
+    utils::scope_guard deallocationGuard = [&] {
+        for (std::size_t i = 0U; i < numIoBuffers; ++i)
+        {
+            mIoBufferManager.deallocate(ioBuffers[i]);
+        }
+    };
+
+    while (!requests.empty())
+    {
+        auto const runLength = coalescable_prefix_size(requests);
+        auto const run = requests.first(runLength);
+        requests = requests.subspan(runLength);
+
+        for (; numIoBuffers < runLength; ++numIoBuffers)
+        {
+            VEFS_TRY(auto ioBuffer, mIoBufferManager.allocate());
+            ioBuffers[numIoBuffers] = ioBuffer;
+        }
+
+        // seal the whole run before issuing the gather write
+        auto const firstSectorIdx = run.front().sector;
+        if constexpr (std::same_as<file_crypto_ctx_T, file_crypto_ctx>)
+        {
+            // with a single provider call
+            std::array<file_crypto_ctx::sector_key_nonce,
+                       max_vectored_sectors>
+                    keyNonces;
+            std::array<crypto::seal_box, max_vectored_sectors> boxes{};
+            for (std::size_t i = 0U; i < runLength; ++i)
+            {
+                std::span<std::byte, sector_size> const sector(
+                        ioBuffers[i].data(), sector_size);
+                VEFS_TRY_INJECT(
+                        run[i].crypto_ctx->derive_seal_key(
+                                sector.first<32>(), keyNonces[i],
+                                session_salt_view()),
+                        ed::sector_idx{run[i].sector});
+                boxes[i] = {
+                        .ciphertext = sector.subspan<32>(),
+                        .mac = run[i].mac,
+                        .key_material = as_span(keyNonces[i]),
+                        .plaintext = run[i].content,
+                };
+            }
+            std::size_t failedBox = 0U;
+            if (auto sealrx = mCryptoProvider->box_seal_batch(
+                        std::span(boxes).first(runLength), failedBox);
+                sealrx.has_failure())
+            {
+                result<void> adaptedrx{std::move(sealrx).as_failure()};
+                adaptedrx.assume_error()
+                        << ed::sector_idx{run[failedBox].sector};
+                return adaptedrx;
+            }
+        }
+        else
+        {
+            for (std::size_t i = 0U; i < runLength; ++i)
+            {
+                VEFS_TRY_INJECT(
+                        run[i].crypto_ctx->seal_sector(
+                                std::span<std::byte, sector_size>(
+                                        ioBuffers[i].data(), sector_size),
+                                run[i].mac, *mCryptoProvider,
+                                session_salt_view(), run[i].content),
+                        ed::sector_idx{run[i].sector});
+            }
+        }
+
+        std::array<io_buffer, max_vectored_sectors> reqBuffers{};
+        for (std::size_t i = 0U; i < runLength; ++i)
+        {
+            reqBuffers[i] = ioBuffers[i];
+        }
+        VEFS_TRY_INJECT(write_raw(std::span(reqBuffers).first(runLength),
+                                  to_offset(firstSectorIdx)),
+                        ed::sector_idx{firstSectorIdx});
+    }
+    return oc::success();
+}
+
 auto sector_device::erase_sector(sector_id const sectorIdx) noexcept
         -> result<void>
 {
-    if (sectorIdx == sector_id::master)
+    return erase_sectors(std::span(&sectorIdx, 1U));
+}
+
+auto sector_device::erase_sectors(std::span<sector_id const> sectors) noexcept
+        -> result<void>
+{
+    using io_buffer = llfio::file_handle::const_buffer_type;
+
+    // overwriting the salt suffices to make a sector unreadable
+    constexpr std::size_t erase_size = 1 << 12;
+    constexpr std::size_t max_batch_size = sector_size / erase_size;
+
+    for (auto const sectorIdx : sectors)
     {
-        return errc::invalid_argument;
+        if (!is_addressable_sector(sectorIdx))
+        {
+            return errc::invalid_argument;
+        }
+    }
+
+    if (mDiscardFreeSectors)
+    {
+        // a discarded sector reads as zeros, i.e. its salt is gone, too
+        while (!sectors.empty())
+        {
+            auto const first = static_cast<std::uint64_t>(sectors.front());
+            std::size_t runLength = 1U;
+            while (runLength < sectors.size()
+                   && static_cast<std::uint64_t>(sectors[runLength])
+                              == first + runLength)
+            {
+                ++runLength;
+            }
+            VEFS_TRY(discard_sectors(sectors.front(), runLength));
+            sectors = sectors.subspan(runLength);
+        }
+        return oc::success();
     }
 
     VEFS_TRY(auto const ioBuffer, mIoBufferManager.allocate());
     utils::scope_guard deallocationGuard = [&] {
         mIoBufferManager.deallocate(ioBuffer);
     };
-    auto const writeBuffer = ioBuffer.first(io_buffer_manager::page_size);
 
-    auto const nonce = mEraseCounter.fetch_add(1, std::memory_order::relaxed);
-    VEFS_TRY(crypto::kdf(writeBuffer, mSessionSalt, ro_blob_cast(nonce),
-                         sector_kdf_erase));
+    while (!sectors.empty())
+    {
+        auto const batch
+                = sectors.first(std::min(sectors.size(), max_batch_size));
+        sectors = sectors.subspan(batch.size());
+
+        // the key is fixed per session, i.e. every batch consumes a nonce
+        auto const nonce
+                = mEraseCounter.fetch_add(1, std::memory_order::relaxed);
+        crypto::chacha20_keystream(ioBuffer.first(batch.size() * erase_size),
+                                   as_span(mEraseKey), nonce);
+
+        std::array<io_buffer, max_batch_size> reqBuffers{};
+        std::array<std::uint64_t, max_batch_size> offsets{};
+        for (std::size_t i = 0U; i < batch.size(); ++i)
+        {
+            reqBuffers[i] = {ioBuffer.data() + i * erase_size, erase_size};
+            offsets[i] = to_offset(batch[i]);
+        }
+
+        if (mIoQueue)
+        {
+            VEFS_TRY_INJECT(mIoQueue->write_scattered(
+                                    std::span(reqBuffers).first(batch.size()),
+                                    std::span(offsets).first(batch.size())),
+                            ed::sector_idx{batch.front()});
+            continue;
+        }
+        for (std::size_t i = 0U; i < batch.size(); ++i)
+        {
+            VEFS_TRY_INJECT(write_raw(std::span(reqBuffers).subspan(i, 1U),
+                                      offsets[i]),
+                            ed::sector_idx{batch[i]});
+        }
+    }
+    return oc::success();
+}
 
-    auto const sectorOffset = to_offset(sectorIdx);
-    llfio::file_handle::const_buffer_type reqBuffers[] = {writeBuffer};
+auto sector_device::discard_sectors(sector_id const first,
+                                    std::uint64_t const num) noexcept
+        -> result<void>
+{
+    if (num == 0U)
+    {
+        return oc::success();
+    }
+    auto const last = static_cast<std::uint64_t>(first) + (num - 1U);
+    if (!is_addressable_sector(first)
+        || last < static_cast<std::uint64_t>(first)
+        || !is_addressable_sector(sector_id{last}))
+    {
+        return errc::invalid_argument;
+    }
 
-    VEFS_TRY_INJECT(mArchiveFile.write({reqBuffers, sectorOffset}),
-                    ed::sector_idx{sectorIdx});
+    // llfio punches a hole if the file system supports it and writes zeros
+    // otherwise
+    VEFS_TRY_INJECT(mArchiveFile.zero({to_offset(first), num * sector_size}),
+                    ed::sector_idx{first});
     return oc::success();
 }
 
@@ -739,4 +1216,10 @@ template result<void> sector_device::write_sector<file_crypto_ctx_interface>(
         sector_id sectorIdx,
         ro_blob<sector_payload_size> data);
 
+template result<void> sector_device::write_sectors(
+        std::span<write_request<file_crypto_ctx> const> requests);
+template result<void>
+sector_device::write_sectors<file_crypto_ctx_interface>(
+        std::span<write_request<file_crypto_ctx_interface> const> requests);
+
 } // namespace vefs::detail
@@ -7,6 +7,7 @@
 
 #include <dplx/dp/legacy/memory_buffer.hpp>
 
+#include <vefs/io_engine.hpp>
 #include <vefs/llfio.hpp>
 
 #include <vefs/crypto/provider.hpp>
@@ -15,6 +16,7 @@
 #include <vefs/utils/secure_array.hpp>
 
 #include "../crypto/counter.hpp"
+#include "../platform/io_uring_queue.hpp"
 #include "archive_header.hpp"
 #include "file_crypto_ctx.hpp"
 #include "file_descriptor.hpp"
@@ -43,6 +45,8 @@ struct master_header
 {
     utils::secure_byte_array<64> master_secret;
     crypto::atomic_counter master_counter;
+    //! the algorithm every box except the static header is sealed with
+    crypto::aead_algorithm aead{crypto::aead_algorithm::unspecified};
 };
 
 class sector_device
@@ -75,16 +79,27 @@ public:
 
     static constexpr auto to_offset(sector_id id) -> std::uint64_t;
 
+    //! the submission queue depth used by the io_uring engine
+    static constexpr unsigned io_queue_depth = 128U;
+
     static auto open_existing(llfio::file_handle fileHandle,
                               crypto::crypto_provider *cryptoProvider,
-                              ro_blob<32> userPRK) noexcept
+                              ro_blob<32> userPRK,
+                              io_engine ioEngine
+                              = io_engine::synchronous) noexcept
             -> result<open_info>;
     static auto create_new(llfio::file_handle fileHandle,
                            crypto::crypto_provider *cryptoProvider,
-                           ro_blob<32> userPRK) noexcept -> result<open_info>;
+                           ro_blob<32> userPRK,
+                           io_engine ioEngine = io_engine::synchronous) noexcept
+            -> result<open_info>;
 
     ~sector_device() = default;
 
+    /**
+     * Reads the sector ciphertext directly into contentDest and decrypts it
+     * in place. contentDest is unspecified if the operation fails.
+     */
     auto read_sector(rw_blob<sector_payload_size> contentDest,
                      file_crypto_ctx const &fileCtx,
                      sector_id sectorIdx,
@@ -97,6 +112,72 @@ public:
                       ro_blob<sector_payload_size> data) noexcept
             -> result<void>;
     auto erase_sector(sector_id sectorIdx) noexcept -> result<void>;
+    /**
+     * Erases a batch of sectors by overwriting their first page with a
+     * keystream. The keystream of up to eight sectors is generated at once
+     * and with the io_uring engine their writes are submitted together.
+     */
+    auto erase_sectors(std::span<sector_id const> sectors) noexcept
+            -> result<void>;
+    /**
+     * Zeroes num sectors starting at first and deallocates their storage
+     * if the host file system supports punching holes, i.e. reading them
+     * yields zeros afterwards.
+     */
+    auto discard_sectors(sector_id first, std::uint64_t num) noexcept
+            -> result<void>;
+
+    /**
+     * If enabled, erase_sectors() discards whole sectors instead of
+     * overwriting their first page and the sector allocator discards the
+     * sectors released by a commit in coalesced ranges. Disabled by default.
+     */
+    void discard_free_sectors(bool enable) noexcept
+    {
+        mDiscardFreeSectors = enable;
+    }
+    auto discards_free_sectors() const noexcept -> bool
+    {
+        return mDiscardFreeSectors;
+    }
+
+    //! the maximum number of sectors coalesced into a single vectored i/o op
+    static constexpr std::size_t max_vectored_sectors = 16;
+
+    struct read_request
+    {
+        rw_blob<sector_payload_size> content;
+        file_crypto_ctx const *crypto_ctx;
+        sector_id sector;
+        ro_blob<16> mac;
+    };
+    template <typename file_crypto_ctx_T = file_crypto_ctx>
+    struct write_request
+    {
+        rw_blob<16> mac;
+        file_crypto_ctx_T *crypto_ctx;
+        sector_id sector;
+        ro_blob<sector_payload_size> content;
+    };
+
+    /**
+     * Reads and decrypts a batch of sectors. Consecutive requests which
+     * address physically adjacent sectors are coalesced into a single
+     * scatter read and decrypted in place with a single box_open_batch()
+     * call.
+     */
+    auto read_sectors(std::span<read_request const> requests) noexcept
+            -> result<void>;
+    /**
+     * Encrypts and writes a batch of sectors. Consecutive requests which
+     * address physically adjacent sectors are sealed up front and written
+     * with a single gather write. The runs of a concrete file_crypto_ctx are
+     * sealed with a single box_seal_batch() call.
+     */
+    template <typename file_crypto_ctx_T = file_crypto_ctx>
+    auto write_sectors(
+            std::span<write_request<file_crypto_ctx_T> const> requests) noexcept
+            -> result<void>;
 
     auto personalization_area() noexcept
             -> std::span<std::byte, personalization_area_size>;
@@ -128,9 +209,22 @@ private:
                   crypto::crypto_provider *cryptoProvider,
                   size_t numSectors);
 
+    auto initialize_io_engine(io_engine ioEngine) noexcept -> result<void>;
+    // fills the buffers completely or fails; a read hitting the end of file
+    // is reported as archive_errc::sector_reference_out_of_range
+    auto read_raw(llfio::file_handle::buffers_type buffers,
+                  std::uint64_t offset) noexcept
+            -> result<llfio::file_handle::buffers_type>;
+    auto write_raw(llfio::file_handle::const_buffers_type buffers,
+                   std::uint64_t offset) noexcept -> result<void>;
+
     auto parse_static_archive_header(ro_blob<32> userPRK) -> result<void>;
+    auto adopt_recorded_aead() noexcept -> result<void>;
     auto parse_archive_header() -> result<archive_header>;
     auto parse_archive_header(header_id which) -> result<archive_header>;
+    // reads the root sectors of the indices referenced by the header in order
+    // to have them cached by the operating system
+    void warm_up_index_roots(archive_header const &header) noexcept;
 
     result<void> write_static_archive_header(ro_blob<32> userPRK);
 
@@ -138,16 +232,22 @@ private:
     constexpr auto header_offset(header_id which) const noexcept -> std::size_t;
     void switch_header() noexcept;
 
-    crypto::crypto_provider *const mCryptoProvider;
+    // the static header must be readable before the recorded algorithm is
+    // known, therefore it is always sealed by the same provider
+    crypto::crypto_provider *const mStaticHeaderCrypto;
+    crypto::crypto_provider *mCryptoProvider;
     llfio::file_handle mArchiveFile;
     llfio::unique_file_lock mArchiveFileLock;
 
     dplx::dp::memory_allocation<llfio::utils::page_allocator<std::byte>>
             mMasterSector;
     io_buffer_manager mIoBufferManager;
+    // if set, sector i/o is issued through this queue instead of mArchiveFile
+    std::unique_ptr<io_uring_queue> mIoQueue;
 
     master_header mStaticHeader;
     utils::secure_byte_array<16> mSessionSalt;
+    utils::secure_byte_array<32> mEraseKey;
     crypto::atomic_counter mArchiveSecretCounter;
     crypto::atomic_counter mJournalCounter;
     std::atomic<std::uint64_t> mEraseCounter;
@@ -155,6 +255,7 @@ private:
     std::atomic<uint64_t> mNumSectors;
 
     header_id mHeaderSelector;
+    bool mDiscardFreeSectors{false};
 };
 static_assert(!std::is_default_constructible_v<sector_device>);
 static_assert(!std::is_copy_constructible_v<sector_device>);
@@ -1,19 +1,37 @@
 #pragma once
 
+#include <cassert>
+#include <cstdint>
+
 #include <algorithm>
+#include <atomic>
+#include <deque>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <new>
 #include <ranges>
 #include <shared_mutex>
+#include <utility>
+#include <vector>
 
 #include <boost/container/static_vector.hpp>
 
 #include <dplx/cncr/misc.hpp>
 
 #include <vefs/cache/cache_mt.hpp>
+#include <vefs/cache/clock_policy.hpp>
 #include <vefs/cache/lru_policy.hpp>
+#include <vefs/cache/sharded_cache_mt.hpp>
+#include <vefs/cache/slru_policy.hpp>
+#include <vefs/cache/variant_policy.hpp>
+#include <vefs/cache/w-tinylfu_policy.hpp>
+#include <vefs/cache_policy.hpp>
+#include <vefs/cache_stats.hpp>
 #include <vefs/llfio.hpp>
+#include <vefs/platform/page_allocator.hpp>
 #include <vefs/platform/platform.hpp>
+#include <vefs/platform/thread_pool.hpp>
 
 #include "file_crypto_ctx.hpp"
 #include "reference_sector_layout.hpp"
@@ -24,6 +42,119 @@
 namespace vefs::detail
 {
 
+/**
+ * Identifies a sector within a sector cache which may be shared by many
+ * trees.
+ */
+struct sector_cache_key
+{
+    //! the id of the tree the sector belongs to
+    std::uint64_t tree;
+    tree_position position;
+
+    auto operator==(sector_cache_key const &other) const noexcept -> bool
+            = default;
+};
+
+/**
+ * The positions of the sectors of a tree which became dirty since its last
+ * commit, i.e. a commit needn't scan a shared cache for the dirty sectors of
+ * its tree. A position may be listed repeatedly and its sector may have been
+ * synchronized in the meantime.
+ */
+class dirty_sector_list
+{
+    std::mutex mSync;
+    std::vector<tree_position> mPositions;
+    // the number of positions left by the last deduplication
+    std::size_t mNumDeduplicated = 0U;
+    // positions have been lost, e.g. due to an allocation failure
+    bool mIncomplete = false;
+
+public:
+    void add(tree_position const position) noexcept
+    {
+        std::lock_guard lock{mSync};
+        if (mIncomplete)
+        {
+            return;
+        }
+        try
+        {
+            // sectors which are evicted and modified again are listed
+            // repeatedly; deduplicate whenever the list doubled in size
+            if (mPositions.size() >= 2U * std::max<std::size_t>(
+                        mNumDeduplicated, min_deduplication_size))
+            {
+                std::ranges::sort(mPositions);
+                auto const duplicates = std::ranges::unique(mPositions);
+                mPositions.erase(duplicates.begin(), duplicates.end());
+                mNumDeduplicated = mPositions.size();
+            }
+            mPositions.push_back(position);
+        }
+        catch (std::bad_alloc const &)
+        {
+            invalidate_locked();
+        }
+    }
+
+    /**
+     * Appends the listed positions to the given vector and clears the list.
+     *
+     * @return false if positions have been lost, i.e. the dirty sectors need
+     *         to be determined by scanning the cache
+     */
+    auto take(std::vector<tree_position> &positions) noexcept -> bool
+    {
+        std::lock_guard lock{mSync};
+        bool complete = !std::exchange(mIncomplete, false);
+        try
+        {
+            positions.insert(positions.end(), mPositions.begin(),
+                             mPositions.end());
+        }
+        catch (std::bad_alloc const &)
+        {
+            complete = false;
+        }
+        mPositions.clear();
+        mNumDeduplicated = 0U;
+        return complete;
+    }
+
+    //! forgets the listed positions and forces the next take() to fail
+    void invalidate() noexcept
+    {
+        std::lock_guard lock{mSync};
+        invalidate_locked();
+    }
+
+private:
+    static constexpr std::size_t min_deduplication_size = 64U;
+
+    void invalidate_locked() noexcept
+    {
+        mIncomplete = true;
+        mPositions.clear();
+        mNumDeduplicated = 0U;
+    }
+};
+
+/**
+ * The per tree state required to load and synchronize its sectors.
+ */
+template <typename TreeAllocator>
+struct sector_tree_context
+{
+    sector_device &device;
+    file_crypto_ctx &cryptoCtx;
+    root_sector_info &rootInfo;
+    TreeAllocator &treeAllocator;
+    std::mutex &rootSync;
+    dirty_sector_list &dirtySectors;
+};
+
 template <typename TreeAllocator>
 class sector_mt
 {
@@ -31,31 +162,41 @@ class sector_mt
     using node_allocation = typename TreeAllocator::sector_allocator;
 
 public:
-    using handle = cache_handle<tree_position, sector_mt const>;
-    using writable_handle = cache_handle<tree_position, sector_mt>;
+    using handle = cache_handle<sector_cache_key, sector_mt const>;
+    using writable_handle = cache_handle<sector_cache_key, sector_mt>;
     using content_span = ro_blob<sector_device::sector_payload_size>;
     using writable_content_span = rw_blob<sector_device::sector_payload_size>;
+    using tree_context = sector_tree_context<TreeAllocator>;
 
 private:
     mutable std::shared_mutex mParentSync;
     handle mParent;
 
+    tree_context *mTree;
+
     mutable std::shared_mutex mSectorSync;
     node_allocation mNodeAllocation;
 
     std::array<std::byte, sector_device::sector_payload_size> mContent;
 
 public:
-    sector_mt(handle parent,
-              tree_allocator &treeAllocator,
-              sector_id current) noexcept
+    sector_mt(handle parent, tree_context &tree, sector_id current) noexcept
         : mParentSync()
         , mParent(std::move(parent))
+        , mTree(&tree)
         , mSectorSync()
-        , mNodeAllocation(treeAllocator, current)
+        , mNodeAllocation(tree.treeAllocator, current)
     {
     }
 
+    /**
+     * retrieves the state of the tree this sector belongs to
+     */
+    auto tree() const noexcept -> tree_context &
+    {
+        return *mTree;
+    }
+
     /**
      * retrieves a handle to the parent
      * the handle will be empty if this is the root sector
@@ -134,32 +275,27 @@ public:
     {
         return mNodeAllocation;
     }
+
+    //! lists the sector for the next commit of its tree
+    void on_dirtied(sector_cache_key const &key) noexcept
+    {
+        mTree->dirtySectors.add(key.position);
+    }
 };
 
+/**
+ * The sector cache traits don't carry any tree specific state, instead each
+ * sector references the context of its tree. Therefore a single cache can be
+ * shared by many trees.
+ */
 template <typename TreeAllocator>
 class sector_cache_traits
 {
-    sector_device &mDevice;
-    file_crypto_ctx &mCryptoCtx;
-    root_sector_info &mRootInfo;
-    TreeAllocator &mTreeAllocator;
-    std::mutex &mRootSync;
-
 public:
     struct initializer_type
     {
-        sector_device &device;
-        file_crypto_ctx &cryptoCtx;
-        root_sector_info &rootInfo;
-        TreeAllocator &treeAllocator;
-        std::mutex &rootSync;
     };
-    explicit sector_cache_traits(initializer_type const &init)
-        : mDevice(init.device)
-        , mCryptoCtx(init.cryptoCtx)
-        , mRootInfo(init.rootInfo)
-        , mTreeAllocator(init.treeAllocator)
-        , mRootSync(init.rootSync)
+    explicit sector_cache_traits(initializer_type const &) noexcept
     {
     }
 
@@ -167,30 +303,46 @@ private:
     using handle = typename sector_mt<TreeAllocator>::handle;
     using writable_handle = typename sector_mt<TreeAllocator>::writable_handle;
     using tree_allocator = TreeAllocator;
+    using tree_context = sector_tree_context<TreeAllocator>;
 
 public:
-    using key_type = tree_position;
+    using key_type = sector_cache_key;
     using value_type = sector_mt<TreeAllocator>;
 
-    using allocator_type = std::allocator<void>;
-    using eviction = least_recently_used_policy<key_type,
-                                                unsigned short,
-                                                allocator_type>;
+    // large caches may be backed by huge pages, see create_cache()
+    using allocator_type = page_allocator<void>;
+    // the alternatives are ordered like the cache_policy enumerators
+    using eviction = variant_policy<
+            least_recently_used_policy<key_type, std::uint32_t, allocator_type>,
+            segmented_least_recently_used_policy<key_type,
+                                                 std::uint32_t,
+                                                 allocator_type>,
+            wtinylfu_policy<key_type, std::uint32_t, allocator_type>,
+            clock_policy<key_type, std::uint32_t, allocator_type>>;
+
+    static constexpr auto policy_index(cache_policy policy) noexcept
+            -> std::size_t
+    {
+        return static_cast<std::size_t>(policy);
+    }
+    static_assert(policy_index(cache_policy::clock) + 1U
+                  == eviction::num_policies);
 
     struct load_context
     {
         mutable handle parent;
+        tree_context *tree;
         int refOffset;
         bool create;
     };
     auto load(load_context const &ctx,
-              [[maybe_unused]] key_type const nodePosition,
+              [[maybe_unused]] key_type const nodeKey,
               utils::object_storage<value_type> &storage) noexcept
             -> result<std::pair<value_type *, bool>>
     {
         if (!ctx.parent)
         {
-            return load_root(storage, ctx.create);
+            return load_root(*ctx.tree, storage, ctx.create);
         }
 
         auto const ref = reference_sector_layout::read(ctx.parent->content(),
@@ -201,7 +353,7 @@ public:
             return archive_errc::sector_reference_out_of_range;
         }
 
-        auto *page = &storage.construct(std::move(ctx.parent), mTreeAllocator,
+        auto *page = &storage.construct(std::move(ctx.parent), *ctx.tree,
                                         ref.sector);
 
         if (ref.sector == sector_id::master)
@@ -210,8 +362,8 @@ public:
         }
         else
         {
-            auto readResult = mDevice.read_sector(page->content(), mCryptoCtx,
-                                                  ref.sector, ref.mac);
+            auto readResult = ctx.tree->device.read_sector(
+                    page->content(), ctx.tree->cryptoCtx, ref.sector, ref.mac);
             if (readResult.has_failure())
             {
                 ctx.parent = std::move(page->parent());
@@ -224,75 +376,235 @@ public:
         return std::pair{page, ref.sector == sector_id::master};
     }
 
+    //! the maximum number of sectors read or written by a single
+    //! load_many() or sync_many() call
+    static constexpr std::size_t max_batch_size
+            = sector_device::max_vectored_sectors;
+
+    /**
+     * Loads siblings which share ctx.parent with a single
+     * sector_device::read_sectors() call, i.e. physically adjacent sectors
+     * are read together.
+     */
+    auto load_many(load_context const &ctx,
+                   std::span<key_type const> nodeKeys,
+                   std::span<utils::object_storage<value_type> *const>
+                           storages) noexcept -> result<void>
+    {
+        assert(ctx.parent && !ctx.create);
+        assert(nodeKeys.size() == storages.size()
+               && nodeKeys.size() <= max_batch_size);
+
+        auto const numNodes = nodeKeys.size();
+        std::array<sector_reference, max_batch_size> refs;
+        for (std::size_t i = 0U; i < numNodes; ++i)
+        {
+            refs[i] = reference_sector_layout::read(
+                    ctx.parent->content(),
+                    nodeKeys[i].position.parent_array_offset());
+            if (refs[i].sector == sector_id::master)
+            {
+                return archive_errc::sector_reference_out_of_range;
+            }
+        }
+
+        std::array<sector_device::read_request, max_batch_size> requests;
+        for (std::size_t i = 0U; i < numNodes; ++i)
+        {
+            auto *page = &storages[i]->construct(ctx.parent, *ctx.tree,
+                                                 refs[i].sector);
+            requests[i] = {
+                    .content = page->content(),
+                    .crypto_ctx = &ctx.tree->cryptoCtx,
+                    .sector = refs[i].sector,
+                    .mac = refs[i].mac,
+            };
+        }
+        std::ranges::sort(std::span(requests).first(numNodes), {},
+                          &sector_device::read_request::sector);
+
+        if (auto readrx = ctx.tree->device.read_sectors(
+                    std::span(requests).first(numNodes));
+            readrx.has_failure())
+        {
+            for (std::size_t i = 0U; i < numNodes; ++i)
+            {
+                storages[i]->destroy();
+            }
+            return std::move(readrx).as_failure();
+        }
+        return oc::success();
+    }
+
 private:
-    auto load_root(utils::object_storage<value_type> &storage,
-                   bool create) noexcept
+    static auto load_root(tree_context &tree,
+                          utils::object_storage<value_type> &storage,
+                          bool create) noexcept
             -> result<std::pair<value_type *, bool>>
     {
-        auto *rootPage = &storage.construct(nullptr, mTreeAllocator,
+        auto *rootPage = &storage.construct(nullptr, tree,
                                             create ? sector_id{}
-                                                   : mRootInfo.root.sector);
+                                                   : tree.rootInfo.root.sector);
         if (create)
         {
             ::vefs::fill_blob(rootPage->content(), std::byte{});
             reference_sector_layout::write(rootPage->content(), 0,
-                                           mRootInfo.root);
+                                           tree.rootInfo.root);
         }
         else
         {
-            VEFS_TRY(mDevice.read_sector(rootPage->content(), mCryptoCtx,
-                                         mRootInfo.root.sector,
-                                         mRootInfo.root.mac));
+            VEFS_TRY(tree.device.read_sector(rootPage->content(),
+                                             tree.cryptoCtx,
+                                             tree.rootInfo.root.sector,
+                                             tree.rootInfo.root.mac));
         }
 
         return std::pair{rootPage, create};
     }
 
 public:
-    auto sync(key_type const nodePosition, value_type &node) noexcept
+    auto sync(key_type const nodeKey, value_type &node) noexcept
             -> result<void>
     {
-        auto const referenceOffset = nodePosition.parent_array_offset();
+        auto const nodePosition = nodeKey.position;
+        auto &tree = node.tree();
 
         std::lock_guard sectorLock{node};
         std::shared_lock parentLock{node.parent_sync()};
 
-        auto const parent = node.parent();
-        auto const content = node.content();
-        if (nodePosition.position() != 0U && nodePosition.layer() > 0
-            && node.num_referenced() == 0)
+        if (is_unreferenced(nodePosition, node))
         {
-            if (parent == nullptr)
-            {
-                std::lock_guard rootLock{mRootSync};
-                mRootInfo.root = {};
-            }
-            else
-            {
-                std::shared_lock parentContentLock{*parent};
-                writable_handle writableParent = parent.as_writable();
-                auto const parentContent = writableParent->content();
+            release(nodePosition, node);
+            return oc::success();
+        }
+
+        sector_reference updated{};
+        VEFS_TRY(updated.sector,
+                 tree.treeAllocator.reallocate(node.allocation()));
+
+        VEFS_TRY_INJECT(tree.device.write_sector(updated.mac, tree.cryptoCtx,
+                                                 updated.sector,
+                                                 node.content()),
+                        ed::sector_tree_position{nodePosition});
+
+        publish(nodePosition, node, updated);
+        return oc::success();
+    }
+    /**
+     * Synchronizes a batch of nodes of the same rank with a single
+     * sector_device::write_sectors() call. The nodes stay locked until their
+     * new location has been published to their parents.
+     */
+    auto sync_many(std::span<key_type const> nodeKeys,
+                   std::span<value_type *const> nodes) noexcept
+            -> result<void>
+    {
+        using write_request = sector_device::write_request<file_crypto_ctx>;
+        assert(nodeKeys.size() == nodes.size()
+               && nodes.size() <= max_batch_size);
+
+        std::array<std::unique_lock<value_type>, max_batch_size> sectorLocks;
+        std::array<std::shared_lock<std::shared_mutex>, max_batch_size>
+                parentLocks;
+        std::array<sector_reference, max_batch_size> updated{};
+        std::array<std::size_t, max_batch_size> written;
+        std::array<write_request, max_batch_size> requests;
+        std::size_t numWritten = 0U;
+
+        sector_device *device = nullptr;
+        for (std::size_t i = 0U; i < nodes.size(); ++i)
+        {
+            auto &node = *nodes[i];
+            auto const nodePosition = nodeKeys[i].position;
+            auto &tree = node.tree();
+
+            sectorLocks[i] = std::unique_lock{node};
+            parentLocks[i] = std::shared_lock{node.parent_sync()};
 
-                reference_sector_layout::write(parentContent, referenceOffset,
-                                               {sector_id{}, {}});
+            if (is_unreferenced(nodePosition, node))
+            {
+                release(nodePosition, node);
+                parentLocks[i].unlock();
+                sectorLocks[i].unlock();
+                continue;
             }
 
-            mTreeAllocator.dealloc(node.allocation(),
-                                   tree_allocator::leak_on_failure);
+            VEFS_TRY(updated[i].sector,
+                     tree.treeAllocator.reallocate(node.allocation()));
+
+            // a shared cache belongs to a single archive
+            assert(device == nullptr || device == &tree.device);
+            device = &tree.device;
+            written[numWritten] = i;
+            requests[numWritten] = {
+                    .mac = updated[i].mac,
+                    .crypto_ctx = &tree.cryptoCtx,
+                    .sector = updated[i].sector,
+                    .content = node.content(),
+            };
+            numWritten += 1U;
+        }
+        if (numWritten == 0U)
+        {
             return oc::success();
         }
 
-        sector_reference updated{};
-        VEFS_TRY(updated.sector, mTreeAllocator.reallocate(node.allocation()));
+        std::ranges::sort(std::span(requests).first(numWritten), {},
+                          &write_request::sector);
+        VEFS_TRY(device->write_sectors(
+                std::span<write_request const>(requests).first(numWritten)));
 
-        VEFS_TRY_INJECT(mDevice.write_sector(updated.mac, mCryptoCtx,
-                                             updated.sector, content),
-                        ed::sector_tree_position{nodePosition});
+        for (auto const i : std::span(written).first(numWritten))
+        {
+            publish(nodeKeys[i].position, *nodes[i], updated[i]);
+        }
+        return oc::success();
+    }
 
+private:
+    // a reference sector without references is deallocated instead of being
+    // written; assumes the caller locked the node and its parent_sync()
+    static auto is_unreferenced(tree_position const nodePosition,
+                                value_type &node) noexcept -> bool
+    {
+        return nodePosition.position() != 0U && nodePosition.layer() > 0
+               && node.num_referenced() == 0;
+    }
+    static void release(tree_position const nodePosition,
+                        value_type &node) noexcept
+    {
+        auto &tree = node.tree();
+        auto const parent = node.parent();
         if (parent == nullptr)
         {
-            std::lock_guard rootLock{mRootSync};
-            mRootInfo.root = updated;
+            std::lock_guard rootLock{tree.rootSync};
+            tree.rootInfo.root = {};
+        }
+        else
+        {
+            std::shared_lock parentContentLock{*parent};
+            writable_handle writableParent = parent.as_writable();
+            auto const parentContent = writableParent->content();
+
+            reference_sector_layout::write(parentContent,
+                                           nodePosition.parent_array_offset(),
+                                           {sector_id{}, {}});
+        }
+
+        tree.treeAllocator.dealloc(node.allocation(),
+                                   tree_allocator::leak_on_failure);
+    }
+    // stores the new location of the node in its parent
+    static void publish(tree_position const nodePosition,
+                        value_type &node,
+                        sector_reference const &updated) noexcept
+    {
+        auto &tree = node.tree();
+        auto const parent = node.parent();
+        if (parent == nullptr)
+        {
+            std::lock_guard rootLock{tree.rootSync};
+            tree.rootInfo.root = updated;
         }
         else
         {
@@ -300,19 +612,20 @@ public:
             writable_handle writableParent = parent.as_writable();
 
             auto const parentContent = writableParent->content();
-            reference_sector_layout::write(parentContent, referenceOffset,
+            reference_sector_layout::write(parentContent,
+                                           nodePosition.parent_array_offset(),
                                            updated);
         }
-        return oc::success();
     }
 
+public:
     struct purge_context
     {
         int refOffset;
         bool ownsLock;
     };
     auto purge(purge_context const &ctx,
-               [[maybe_unused]] key_type nodePosition,
+               [[maybe_unused]] key_type nodeKey,
                value_type &node) noexcept -> result<void>
     {
         {
@@ -324,8 +637,8 @@ public:
                                                ctx.refOffset, {});
             }
         }
-        mTreeAllocator.dealloc(node.allocation(),
-                               tree_allocator::leak_on_failure);
+        node.tree().treeAllocator.dealloc(node.allocation(),
+                                          tree_allocator::leak_on_failure);
         if (ctx.ownsLock)
         {
             node.parent_sync().unlock();
@@ -353,6 +666,9 @@ public:
  * sector_references per reference sector, this works out to a maximum number of
  * five layers (one data sector layer and four reference sector layers). See
  * tree_lut.hpp for further details on limits on sector trees.
+ *
+ * The tree either owns its sector cache or shares a cache with other trees in
+ * which case the cached sectors are keyed by a process wide unique tree id.
  */
 template <typename TreeAllocator>
 class sector_tree_mt
@@ -363,14 +679,26 @@ public:
 private:
     using sector = sector_mt<TreeAllocator>;
     using traits = sector_cache_traits<TreeAllocator>;
-    using sector_cache = cache_mt<traits>;
+    using tree_context = sector_tree_context<TreeAllocator>;
+
+public:
+    using sector_cache = sharded_cache_mt<traits>;
+    using sector_cache_allocator = typename traits::allocator_type;
+
+private:
     using sector_handle = typename sector_cache::handle;
 
     root_sector_info mRootInfo;
 
     tree_allocator mTreeAllocator;
     std::mutex mRootSync;
-    sector_cache mSectorCache;
+    dirty_sector_list mDirtySectors;
+    tree_context mContext;
+    // distinguishes the sectors of this tree within a shared cache
+    std::uint64_t mId;
+    // empty if the tree uses a cache shared with other trees
+    std::unique_ptr<sector_cache> mOwnedCache;
+    sector_cache &mSectorCache;
     sector_handle mRootSector; // needs to be destructed before mSectorCache
 
 private:
@@ -378,22 +706,39 @@ private:
     sector_tree_mt(sector_device &device,
                    file_crypto_ctx &cryptoCtx,
                    root_sector_info rootInfo,
+                   std::unique_ptr<sector_cache> ownedCache,
+                   sector_cache &sectorCache,
                    AllocatorCtorArgs &&...allocatorCtorArgs)
         : mRootInfo(rootInfo)
         , mTreeAllocator(std::forward<AllocatorCtorArgs>(allocatorCtorArgs)...)
         , mRootSync()
-        , mSectorCache(1024U,
-                       {
-                               .device = device,
-                               .cryptoCtx = cryptoCtx,
-                               .rootInfo = mRootInfo,
-                               .treeAllocator = mTreeAllocator,
-                               .rootSync = mRootSync,
-                       })
+        , mDirtySectors()
+        , mContext{
+                  .device = device,
+                  .cryptoCtx = cryptoCtx,
+                  .rootInfo = mRootInfo,
+                  .treeAllocator = mTreeAllocator,
+                  .rootSync = mRootSync,
+                  .dirtySectors = mDirtySectors,
+          }
+        , mId(next_tree_id())
+        , mOwnedCache(std::move(ownedCache))
+        , mSectorCache(sectorCache)
         , mRootSector()
     {
     }
 
+    static auto next_tree_id() noexcept -> std::uint64_t
+    {
+        static std::atomic<std::uint64_t> counter{0U};
+        return counter.fetch_add(1U, std::memory_order::relaxed);
+    }
+
+    auto key_of(tree_position position) const noexcept -> sector_cache_key
+    {
+        return {.tree = mId, .position = position};
+    }
+
     auto initialize(bool createNew) noexcept -> result<void>
     {
         tree_position const rootPosition(0U, mRootInfo.tree_depth);
@@ -401,11 +746,13 @@ private:
         {
             typename traits::load_context rootLoadCtx{
                     .parent = {},
+                    .tree = &mContext,
                     .refOffset = 0,
                     .create = true,
             };
-            VEFS_TRY(mRootSector, mSectorCache.pin_or_load(
-                                          rootLoadCtx, tree_position{0U, 1}));
+            VEFS_TRY(mRootSector,
+                     mSectorCache.pin_or_load(rootLoadCtx,
+                                              key_of(tree_position{0U, 1})));
             if (!createNew)
             {
                 auto const writableRoot = mRootSector.as_writable();
@@ -414,20 +761,23 @@ private:
             }
             rootLoadCtx = typename traits::load_context{
                     .parent = mRootSector,
+                    .tree = &mContext,
                     .refOffset = 0,
                     .create = createNew,
             };
-            VEFS_TRY(mSectorCache.pin_or_load(rootLoadCtx, rootPosition));
+            VEFS_TRY(mSectorCache.pin_or_load(rootLoadCtx,
+                                              key_of(rootPosition)));
         }
         else
         {
             typename traits::load_context rootLoadCtx{
                     .parent = {},
+                    .tree = &mContext,
                     .refOffset = 0,
                     .create = false,
             };
-            VEFS_TRY(mRootSector,
-                     mSectorCache.pin_or_load(rootLoadCtx, rootPosition));
+            VEFS_TRY(mRootSector, mSectorCache.pin_or_load(
+                                          rootLoadCtx, key_of(rootPosition)));
 
             if (mRootInfo.tree_depth > 1)
             {
@@ -442,55 +792,140 @@ private:
         return oc::success();
     }
 
-public:
     template <typename... AllocatorCtorArgs>
-    static auto open_existing(sector_device &device,
-                              file_crypto_ctx &cryptoCtx,
-                              root_sector_info rootInfo,
-                              AllocatorCtorArgs &&...args)
+    static auto open_impl(bool createNew,
+                          sector_device &device,
+                          file_crypto_ctx &cryptoCtx,
+                          root_sector_info rootInfo,
+                          std::unique_ptr<sector_cache> ownedCache,
+                          sector_cache &sectorCache,
+                          AllocatorCtorArgs &&...args)
             -> result<std::unique_ptr<sector_tree_mt>>
     {
         std::unique_ptr<sector_tree_mt> tree;
         try
         {
             tree.reset(new sector_tree_mt(
-                    device, cryptoCtx, rootInfo,
-                    std::forward<AllocatorCtorArgs>(args)...));
+                    device, cryptoCtx, rootInfo, std::move(ownedCache),
+                    sectorCache, std::forward<AllocatorCtorArgs>(args)...));
         }
         catch (std::bad_alloc const &)
         {
             return errc::not_enough_memory;
         }
 
-        VEFS_TRY(tree->initialize(false));
+        VEFS_TRY(tree->initialize(createNew));
         return oc::success(std::move(tree));
     }
 
-    template <typename... AllocatorCtorArgs>
-    static auto create_new(sector_device &device,
-                           file_crypto_ctx &cryptoCtx,
-                           AllocatorCtorArgs &&...args)
-            -> result<std::unique_ptr<sector_tree_mt>>
+public:
+    //! the number of cached sectors used by trees which aren't sized by an
+    //! archive wide cache budget
+    static constexpr std::uint32_t default_cache_size = 1024U;
+
+    ~sector_tree_mt() noexcept
+    {
+        mRootSector = nullptr;
+        if (!mOwnedCache)
+        {
+            // the sectors reference mContext, i.e. they must not outlive us;
+            // this also waits for concurrent evictions of our dirty sectors
+            // which are written through mContext
+            [[maybe_unused]] auto const numPinned = mSectorCache.discard_if(
+                    [id = mId](sector_cache_key const &key) noexcept {
+                        return key.tree == id;
+                    });
+            assert(numPinned == 0U);
+        }
+    }
+
+    /**
+     * Creates a sector cache which can be shared by many trees. It must
+     * outlive every tree using it. The allocator may back the cache pages
+     * with huge pages and place each shard on a NUMA node.
+     */
+    static auto
+    create_cache(std::uint32_t numCachePages,
+                 cache_policy policy,
+                 sector_cache_allocator const &alloc = {}) noexcept
+            -> result<std::unique_ptr<sector_cache>>
     {
-        std::unique_ptr<sector_tree_mt> tree;
         try
         {
-            tree.reset(new sector_tree_mt(
-                    device, cryptoCtx, {},
-                    std::forward<AllocatorCtorArgs>(args)...));
+            return std::make_unique<sector_cache>(
+                    numCachePages,
+                    sector_cache::suggested_num_shards(numCachePages),
+                    typename traits::initializer_type{},
+                    &thread_pool::shared(), alloc,
+                    traits::policy_index(policy));
         }
         catch (std::bad_alloc const &)
         {
             return errc::not_enough_memory;
         }
+    }
 
-        VEFS_TRY(tree->initialize(true));
-        return oc::success(std::move(tree));
+    template <typename... AllocatorCtorArgs>
+    static auto open_existing(sector_device &device,
+                              file_crypto_ctx &cryptoCtx,
+                              root_sector_info rootInfo,
+                              std::uint32_t numCachePages,
+                              cache_policy policy,
+                              AllocatorCtorArgs &&...args)
+            -> result<std::unique_ptr<sector_tree_mt>>
+    {
+        VEFS_TRY(auto &&cache, create_cache(numCachePages, policy));
+        auto &sectorCache = *cache;
+        return open_impl(false, device, cryptoCtx, rootInfo, std::move(cache),
+                         sectorCache, std::forward<AllocatorCtorArgs>(args)...);
+    }
+    /**
+     * Opens the tree on top of a sector cache which is shared with other
+     * trees.
+     */
+    template <typename... AllocatorCtorArgs>
+    static auto open_existing(sector_device &device,
+                              file_crypto_ctx &cryptoCtx,
+                              root_sector_info rootInfo,
+                              sector_cache &sharedCache,
+                              AllocatorCtorArgs &&...args)
+            -> result<std::unique_ptr<sector_tree_mt>>
+    {
+        return open_impl(false, device, cryptoCtx, rootInfo, nullptr,
+                         sharedCache, std::forward<AllocatorCtorArgs>(args)...);
+    }
+
+    template <typename... AllocatorCtorArgs>
+    static auto create_new(sector_device &device,
+                           file_crypto_ctx &cryptoCtx,
+                           std::uint32_t numCachePages,
+                           cache_policy policy,
+                           AllocatorCtorArgs &&...args)
+            -> result<std::unique_ptr<sector_tree_mt>>
+    {
+        VEFS_TRY(auto &&cache, create_cache(numCachePages, policy));
+        auto &sectorCache = *cache;
+        return open_impl(true, device, cryptoCtx, {}, std::move(cache),
+                         sectorCache, std::forward<AllocatorCtorArgs>(args)...);
+    }
+    /**
+     * Creates the tree on top of a sector cache which is shared with other
+     * trees.
+     */
+    template <typename... AllocatorCtorArgs>
+    static auto create_new(sector_device &device,
+                           file_crypto_ctx &cryptoCtx,
+                           sector_cache &sharedCache,
+                           AllocatorCtorArgs &&...args)
+            -> result<std::unique_ptr<sector_tree_mt>>
+    {
+        return open_impl(true, device, cryptoCtx, {}, nullptr, sharedCache,
+                         std::forward<AllocatorCtorArgs>(args)...);
     }
 
-    class write_handle final : cache_handle<tree_position, sector>
+    class write_handle final : cache_handle<sector_cache_key, sector>
     {
-        using base_type = cache_handle<tree_position, sector>;
+        using base_type = cache_handle<sector_cache_key, sector>;
 
     public:
         write_handle() noexcept = default;
@@ -508,7 +943,7 @@ public:
 
         auto node_position() const noexcept -> tree_position
         {
-            return base_type::key();
+            return base_type::key().position;
         }
 
         friend inline auto as_span(write_handle const &self) noexcept
@@ -518,9 +953,9 @@ public:
         }
     };
 
-    class read_handle final : cache_handle<tree_position, sector const>
+    class read_handle final : cache_handle<sector_cache_key, sector const>
     {
-        using base_type = cache_handle<tree_position, sector const>;
+        using base_type = cache_handle<sector_cache_key, sector const>;
 
     public:
         read_handle() noexcept = default;
@@ -547,7 +982,7 @@ public:
 
         auto node_position() const noexcept -> tree_position
         {
-            return base_type::key();
+            return base_type::key().position;
         }
 
         friend inline auto as_span(read_handle const &self) noexcept
@@ -584,26 +1019,78 @@ public:
                                    node};
         VEFS_TRY(sector_handle mountPoint,
                  access<true>(sectorPath.begin(), sectorPath.end()));
-        if (mountPoint.key() == node)
+        if (mountPoint.key().position == node)
         {
             return read_handle(std::move(mountPoint));
         }
 
         for (auto it
-             = tree_path::iterator(sectorPath, mountPoint.key().layer() - 1),
+             = tree_path::iterator(sectorPath,
+                                   mountPoint.key().position.layer() - 1),
              end = sectorPath.end();
              it != end; ++it)
         {
             typename traits::load_context childLoadContext{
                     .parent = std::move(mountPoint),
+                    .tree = &mContext,
                     .refOffset = it.array_offset(),
                     .create = true,
             };
             VEFS_TRY(mountPoint,
-                     mSectorCache.pin_or_load(childLoadContext, *it));
+                     mSectorCache.pin_or_load(childLoadContext, key_of(*it)));
         }
         return read_handle(std::move(mountPoint));
     }
+    /**
+     * Loads the allocated leaves within [firstLeaf, lastLeaf) which aren't
+     * cached yet. Siblings are loaded in batches, i.e. physically adjacent
+     * sectors are read and decrypted together.
+     */
+    auto prefetch(std::uint64_t firstLeaf, std::uint64_t const lastLeaf)
+            -> result<void>
+    {
+        using boost::container::static_vector;
+        constexpr std::uint64_t refsPerSector
+                = reference_sector_layout::references_per_sector;
+
+        while (firstLeaf < lastLeaf)
+        {
+            // the leaves of a batch must share their parent
+            auto const parentPosition = firstLeaf / refsPerSector;
+            auto const batchEnd
+                    = std::min({lastLeaf, (parentPosition + 1U) * refsPerSector,
+                                firstLeaf + traits::max_batch_size});
+
+            tree_path const parentPath(tree_position{parentPosition, 1});
+            VEFS_TRY(auto &&parent,
+                     access<false>(parentPath.begin(), parentPath.end()));
+
+            static_vector<sector_cache_key, traits::max_batch_size> keys;
+            for (auto leaf = firstLeaf; leaf < batchEnd; ++leaf)
+            {
+                tree_position const position{leaf};
+                if (reference_sector_layout::read(
+                            parent->content(), position.parent_array_offset())
+                            .sector
+                    != sector_id{})
+                {
+                    keys.push_back(key_of(position));
+                }
+            }
+            typename traits::load_context batchLoadContext{
+                    .parent = std::move(parent),
+                    .tree = &mContext,
+                    .refOffset = 0,
+                    .create = false,
+            };
+            VEFS_TRY(mSectorCache.load_many(
+                    batchLoadContext,
+                    std::span<sector_cache_key const>(keys)));
+
+            firstLeaf = batchEnd;
+        }
+        return success();
+    }
     /**
      * Erase a leaf node at the given position.
      */
@@ -655,6 +1142,118 @@ public:
         }
     };
 
+    /**
+     * Returns the statistics of the sector cache used by this tree. Note that
+     * a shared cache reports the accesses of all trees using it.
+     */
+    auto cache_stats() const noexcept -> vefs::cache_stats
+    {
+        return mSectorCache.stats();
+    }
+    //! the number of pages of the sector cache used by this tree
+    auto cache_size() const noexcept -> std::uint32_t
+    {
+        return mSectorCache.size();
+    }
+
+private:
+    /**
+     * Synchronizes the dirty sectors of this tree, i.e. the ones listed by
+     * mDirtySectors, layer by layer. Only if the list is incomplete the
+     * (possibly shared) cache is scanned for them.
+     */
+    auto sync_dirty_sectors() noexcept -> result<void>
+    {
+        std::vector<tree_position> positions;
+        std::vector<tree_position> deferred;
+        std::vector<sector_cache_key> keys;
+        if (!mDirtySectors.take(positions))
+        {
+            return sync_dirty_sectors_by_scan();
+        }
+        try
+        {
+            for (int round = 0;
+                 !positions.empty() && round <= lut::max_tree_depth; ++round)
+            {
+                // children need to be synchronized before their parents in
+                // order to propagate their new location and MAC
+                int previousLayer = -1;
+                while (!positions.empty())
+                {
+                    std::ranges::sort(positions);
+                    auto const duplicates = std::ranges::unique(positions);
+                    positions.erase(duplicates.begin(), duplicates.end());
+
+                    // sectors of the layers synchronized so far have been
+                    // modified concurrently, i.e. they are left to the next
+                    // round
+                    auto const first = std::ranges::find_if(
+                            positions,
+                            [previousLayer](tree_position const position) {
+                                return position.layer() > previousLayer;
+                            });
+                    deferred.insert(deferred.end(), positions.begin(), first);
+                    positions.erase(positions.begin(), first);
+                    if (positions.empty())
+                    {
+                        break;
+                    }
+
+                    auto const layer = positions.front().layer();
+                    auto const layerEnd = std::ranges::find_if(
+                            positions, [layer](tree_position const position) {
+                                return position.layer() != layer;
+                            });
+                    keys.clear();
+                    for (auto it = positions.begin(); it != layerEnd; ++it)
+                    {
+                        keys.push_back(key_of(*it));
+                    }
+                    positions.erase(positions.begin(), layerEnd);
+
+                    VEFS_TRY(mSectorCache.sync_keys(keys));
+                    previousLayer = layer;
+
+                    // the synchronization modified the parents
+                    if (!mDirtySectors.take(positions))
+                    {
+                        return sync_dirty_sectors_by_scan();
+                    }
+                }
+                positions.swap(deferred);
+                deferred.clear();
+            }
+        }
+        catch (std::bad_alloc const &)
+        {
+            return sync_dirty_sectors_by_scan();
+        }
+        // the sectors which kept being modified are left to the next commit
+        for (auto const position : positions)
+        {
+            mDirtySectors.add(position);
+        }
+        return oc::success();
+    }
+    auto sync_dirty_sectors_by_scan() noexcept -> result<void>
+    {
+        auto const syncRank = [](sector_cache_key const &key) noexcept {
+            return key.position.layer();
+        };
+        // the cache may be shared with other trees
+        auto const isOwned = [id = mId](sector_cache_key const &key) noexcept {
+            return key.tree == id;
+        };
+        bool anyDirty = true;
+        for (int i = 0; anyDirty && i <= lut::max_tree_depth; ++i)
+        {
+            VEFS_TRY(anyDirty, mSectorCache.sync_all_if(isOwned, syncRank));
+        }
+        return oc::success();
+    }
+
+public:
     /**
      * Forces all cached information to be written to disc.
      */
@@ -663,10 +1262,11 @@ public:
     {
         using boost::container::static_vector;
 
-        bool anyDirty = true;
-        for (int i = 0; anyDirty && i <= lut::max_tree_depth; ++i)
+        if (auto syncRx = sync_dirty_sectors(); syncRx.has_failure())
         {
-            VEFS_TRY(anyDirty, mSectorCache.sync_all());
+            // the remaining dirty sectors are unknown
+            mDirtySectors.invalidate();
+            return std::move(syncRx).as_failure();
         }
 
         static_vector<anchor_commit_lock, lut::max_tree_depth + 1> anchors;
@@ -709,12 +1309,14 @@ public:
                 mRootInfo.root
                         = reference_sector_layout::read(parent->content(), 0);
             }
-            mRootInfo.tree_depth = actualRoot.key().layer();
+            mRootInfo.tree_depth = actualRoot.key().position.layer();
         }
 
         // try to shrink the tree height to fit
         for (size_t i = anchors.size() - 1U;
-             i != 0U && anchors[i].handle.key().layer() > mRootInfo.tree_depth;
+             i != 0U
+             && anchors[i].handle.key().position.layer()
+                        > mRootInfo.tree_depth;
              --i)
         {
             typename traits::purge_context purgeContext{
@@ -741,7 +1343,7 @@ public:
                 break;
             }
         }
-        if (mRootSector.key().layer() > mRootInfo.tree_depth)
+        if (mRootSector.key().position.layer() > mRootInfo.tree_depth)
         {
             mTreeAllocator.dealloc(mRootSector.as_writable()->allocation(),
                                    tree_allocator::leak_on_failure);
@@ -775,8 +1377,8 @@ private:
         auto it = std::find_if(std::make_reverse_iterator(pathEnd),
                                std::make_reverse_iterator(pathBegin),
                                [this, &base](tree_position position) {
-                                   return (base
-                                           = mSectorCache.try_pin(position));
+                                   return (base = mSectorCache.try_pin(
+                                                   key_of(position)));
                                })
                           .base();
 
@@ -811,10 +1413,12 @@ private:
         {
             typename traits::load_context childLoadContext{
                     .parent = std::move(base),
+                    .tree = &mContext,
                     .refOffset = it.array_offset(),
                     .create = false,
             };
-            if (auto entry = mSectorCache.pin_or_load(childLoadContext, *it);
+            if (auto entry
+                = mSectorCache.pin_or_load(childLoadContext, key_of(*it));
                 entry.has_value())
             {
                 base = std::move(entry).assume_value();
@@ -836,7 +1440,8 @@ private:
     }
     auto get_anchor_sector(int anchorDepth) -> result<sector_handle>
     {
-        sector_handle anchor = mSectorCache.try_pin(tree_position{0U, 1});
+        sector_handle anchor
+                = mSectorCache.try_pin(key_of(tree_position{0U, 1}));
         sector_handle parent;
         for (int i = 1; i < anchorDepth; ++i, anchor = std::move(parent))
         {
@@ -865,11 +1470,12 @@ private:
 
             typename traits::load_context rootLoadContext{
                     .parent = {},
+                    .tree = &mContext,
                     .refOffset = 0,
                     .create = true,
             };
-            VEFS_TRY(parent,
-                     mSectorCache.pin_or_load(rootLoadContext, nextRootPos));
+            VEFS_TRY(parent, mSectorCache.pin_or_load(rootLoadContext,
+                                                      key_of(nextRootPos)));
 
             auto const writableAnchor = anchor.as_writable();
             writableAnchor->parent(parent);
@@ -975,4 +1581,105 @@ inline auto extract(sector_tree_mt<TreeAllocator> &tree,
     return oc::success();
 }
 
+/**
+ * Pipelined variant of extract() which loads and decrypts up to
+ * extract_pipeline_depth leaf sectors ahead on the given executor while the
+ * preceding ones are written to the target file in order.
+ *
+ * A load which hasn't been picked up by a worker once its sector is due is
+ * run by the calling thread, i.e. it never waits for queued work and can
+ * therefore be called from within a worker of the same executor.
+ */
+template <typename TreeAllocator>
+inline auto extract(sector_tree_mt<TreeAllocator> &tree,
+                    llfio::file_handle &fileHandle,
+                    std::uint64_t startPos,
+                    std::uint64_t endPos,
+                    thread_pool &executor) -> result<void>
+{
+    using read_handle = typename sector_tree_mt<TreeAllocator>::read_handle;
+    constexpr std::size_t extract_pipeline_depth = 16U;
+
+    struct pending_load
+    {
+        std::atomic<bool> claimed{false};
+        std::packaged_task<result<read_handle>()> load;
+        std::future<result<read_handle>> loaded;
+
+        // whoever claims the load first runs it
+        auto try_claim() noexcept -> bool
+        {
+            return !claimed.exchange(true, std::memory_order::acq_rel);
+        }
+    };
+
+    if (startPos >= endPos)
+    {
+        return oc::success();
+    }
+
+    auto offset = startPos % detail::sector_device::sector_payload_size;
+    auto nextLeaf = detail::lut::sector_position_of(startPos);
+    auto const endLeaf = detail::lut::sector_position_of(endPos - 1) + 1;
+
+    std::deque<std::shared_ptr<pending_load>> pendingLoads;
+    VEFS_SCOPE_EXIT
+    {
+        // the loads reference the tree and therefore must not outlive us,
+        // i.e. the queued ones are revoked and the running ones are awaited
+        for (auto &pendingLoad : pendingLoads)
+        {
+            if (!pendingLoad->try_claim())
+            {
+                pendingLoad->loaded.wait();
+            }
+        }
+    };
+
+    while (startPos < endPos)
+    {
+        for (; nextLeaf < endLeaf
+               && pendingLoads.size() < extract_pipeline_depth;
+             ++nextLeaf)
+        {
+            auto pendingLoad = std::make_shared<pending_load>();
+            pendingLoad->load = std::packaged_task<result<read_handle>()>(
+                    [&tree, leaf = nextLeaf] {
+                        return tree.access(tree_position{leaf});
+                    });
+            pendingLoad->loaded = pendingLoad->load.get_future();
+
+            pendingLoads.push_back(pendingLoad);
+            executor.execute([pendingLoad = std::move(pendingLoad)] {
+                if (pendingLoad->try_claim())
+                {
+                    pendingLoad->load();
+                }
+            });
+        }
+
+        auto const pendingLoad = std::move(pendingLoads.front());
+        pendingLoads.pop_front();
+        if (pendingLoad->try_claim())
+        {
+            pendingLoad->load();
+        }
+        VEFS_TRY(auto sector, pendingLoad->loaded.get());
+
+        auto chunk = as_span(sector).subspan(std::exchange(offset, 0));
+        auto chunkSize = std::min(chunk.size(),
+                                  utils::uint64_to_size(endPos - startPos));
+
+        llfio::file_handle::const_buffer_type buffers[1] = {
+                {chunk.data(), chunkSize}
+        };
+
+        VEFS_TRY(fileHandle.write({buffers, startPos}));
+
+        startPos += chunkSize;
+    }
+
+    return oc::success();
+}
+
 } // namespace vefs::detail
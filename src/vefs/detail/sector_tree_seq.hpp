@@ -2,6 +2,8 @@
 
 #include <cassert>
 
+#include <algorithm>
+#include <array>
 #include <optional>
 
 #include <boost/container/static_vector.hpp>
@@ -130,6 +132,12 @@ public:
             -> result<void>;
 
     auto erase_leaf(std::uint64_t leafId) noexcept -> result<void>;
+    /**
+     * Erases the leaves [1, lastLeafId] in reverse order. Unlike calling
+     * erase_leaf() for each of them the released sectors are erased in
+     * batches.
+     */
+    auto erase_leaves(std::uint64_t lastLeafId) noexcept -> result<void>;
     auto erase_self() noexcept -> result<void>;
 
     template <typename Fn>
@@ -169,6 +177,10 @@ private:
 
     auto collect_intermediate_nodes() noexcept -> result<void>;
 
+    //! erases and deallocates a sector which is no longer referenced
+    auto release_sector(sector_id sector) noexcept -> result<void>;
+    auto flush_erasures() noexcept -> result<void>;
+
     auto collect_next_layer(utils::bitset_overlay bitset) -> result<void>;
 
     auto sync_to_device(int const layer) noexcept -> result<void>;
@@ -206,6 +218,12 @@ private:
 
     tree_allocator_type mTreeAllocator;
     data_storage_container_type mDataBlocks;
+
+    // released sectors which erase_leaves() hasn't erased yet
+    std::array<sector_id, sector_device::max_vectored_sectors>
+            mPendingErasures;
+    std::size_t mNumPendingErasures;
+    bool mDeferErasures;
 };
 
 template <typename TreeAllocator>
@@ -223,6 +241,9 @@ inline sector_tree_seq<TreeAllocator>::sector_tree_seq(
     , mNodeInfos()
     , mTreeAllocator(std::forward<AllocatorCtorArgs>(allocatorCtorArgs)...)
     , mDataBlocks()
+    , mPendingErasures()
+    , mNumPendingErasures(0U)
+    , mDeferErasures(false)
 {
 }
 template <typename TreeAllocator>
@@ -555,16 +576,33 @@ sector_tree_seq<TreeAllocator>::erase_leaf(std::uint64_t leafId) noexcept
     auto refNode = ref_node(1);
 
     auto const ref = refNode.read(refOffset);
-    VEFS_TRY(mDevice.erase_sector(ref.sector));
+    VEFS_TRY(release_sector(ref.sector));
 
-    mTreeAllocator.dealloc_one(ref.sector,
-                               tree_allocator_type::leak_on_failure);
     node(1).mDirty = true;
     refNode.write(refOffset, {});
 
     return collect_intermediate_nodes();
 }
 
+template <typename TreeAllocator>
+inline auto
+sector_tree_seq<TreeAllocator>::erase_leaves(std::uint64_t lastLeafId) noexcept
+        -> result<void>
+{
+    mDeferErasures = true;
+    for (auto it = lastLeafId; it > 0; --it)
+    {
+        if (auto eraserx = erase_leaf(it); eraserx.has_failure())
+        {
+            (void)flush_erasures();
+            mDeferErasures = false;
+            return eraserx;
+        }
+    }
+    mDeferErasures = false;
+    return flush_erasures();
+}
+
 template <typename TreeAllocator>
 inline auto sector_tree_seq<TreeAllocator>::erase_self() noexcept
         -> result<void>
@@ -578,10 +616,7 @@ inline auto sector_tree_seq<TreeAllocator>::erase_self() noexcept
     {
         return success();
     }
-    VEFS_TRY(mDevice.erase_sector(mRootInfo.root.sector));
-    mTreeAllocator.dealloc_one(mRootInfo.root.sector,
-                               tree_allocator_type::leak_on_failure);
-    return success();
+    return release_sector(mRootInfo.root.sector);
 }
 
 template <typename TreeAllocator>
@@ -720,10 +755,8 @@ sector_tree_seq<TreeAllocator>::collect_intermediate_nodes() noexcept
         auto refs = ref_node(i + 1);
         auto const nodeRefOffset = mCurrentPath.offset(i);
         auto const nodeRef = refs.read(nodeRefOffset);
-        VEFS_TRY(mDevice.erase_sector(nodeRef.sector));
+        VEFS_TRY(release_sector(nodeRef.sector));
 
-        mTreeAllocator.dealloc_one(nodeRef.sector,
-                                   tree_allocator_type::leak_on_failure);
         refs.write(nodeRefOffset, {});
         node(i + 1).mDirty = true;
     }
@@ -749,9 +782,7 @@ sector_tree_seq<TreeAllocator>::collect_intermediate_nodes() noexcept
         }
 
         auto const newRootRef = ref_node(i).read(0);
-        VEFS_TRY(mDevice.erase_sector(mRootInfo.root.sector));
-        mTreeAllocator.dealloc_one(mRootInfo.root.sector,
-                                   tree_allocator_type::leak_on_failure);
+        VEFS_TRY(release_sector(mRootInfo.root.sector));
 
         mRootInfo.root = newRootRef;
         mRootInfo.tree_depth -= 1;
@@ -765,6 +796,58 @@ sector_tree_seq<TreeAllocator>::collect_intermediate_nodes() noexcept
     return success();
 }
 
+template <typename TreeAllocator>
+inline auto
+sector_tree_seq<TreeAllocator>::release_sector(sector_id const sector) noexcept
+        -> result<void>
+{
+    if (!mDeferErasures)
+    {
+        VEFS_TRY(mDevice.erase_sector(sector));
+        mTreeAllocator.dealloc_one(sector,
+                                   tree_allocator_type::leak_on_failure);
+        return success();
+    }
+    mPendingErasures[mNumPendingErasures++] = sector;
+    if (mNumPendingErasures == mPendingErasures.size())
+    {
+        return flush_erasures();
+    }
+    return success();
+}
+
+template <typename TreeAllocator>
+inline auto sector_tree_seq<TreeAllocator>::flush_erasures() noexcept
+        -> result<void>
+{
+    auto const pending
+            = std::span(mPendingErasures).first(mNumPendingErasures);
+    mNumPendingErasures = 0U;
+    if (pending.empty())
+    {
+        return success();
+    }
+
+    // adjacent sectors are erased as a single range
+    std::ranges::sort(pending);
+
+    // the sectors are no longer referenced, i.e. they are leaked if they
+    // can't be erased
+    if (auto eraserx = mDevice.erase_sectors(pending); eraserx.has_failure())
+    {
+        mTreeAllocator.on_leak_detected();
+        return eraserx;
+    }
+    // erase_sectors() already discarded them if the device discards free
+    // sectors, i.e. deallocating them is mere bookkeeping
+    for (auto const sector : pending)
+    {
+        mTreeAllocator.dealloc_one(sector,
+                                   tree_allocator_type::leak_on_failure);
+    }
+    return success();
+}
+
 template <typename TreeAllocator>
 inline auto sector_tree_seq<TreeAllocator>::sync_to_device(int layer) noexcept
         -> result<void>
@@ -823,10 +906,7 @@ inline auto erase_contiguous(sector_tree_seq<TreeAllocator> &tree,
 {
     if (maxExtent > sector_device::sector_payload_size)
     {
-        for (auto it = lut::sector_position_of(maxExtent - 1); it > 0; --it)
-        {
-            VEFS_TRY(tree.erase_leaf(it));
-        }
+        VEFS_TRY(tree.erase_leaves(lut::sector_position_of(maxExtent - 1)));
     }
 
     return tree.erase_self();
@@ -0,0 +1,486 @@
+#include "io_uring_queue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <string_view>
+#include <thread>
+
+#include <boost/predef/os.h>
+
+#if defined BOOST_OS_LINUX_AVAILABLE
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace vefs::detail
+{
+
+struct io_uring_queue::operation
+{
+    std::byte const *data;
+    std::size_t size;
+    std::uint64_t offset;
+    bool write;
+    bool fixed;
+    int result;
+    std::atomic<bool> done;
+};
+
+#if defined BOOST_OS_LINUX_AVAILABLE
+
+namespace
+{
+
+auto sys_io_uring_setup(unsigned entries, io_uring_params *params) noexcept
+        -> int
+{
+    return static_cast<int>(::syscall(__NR_io_uring_setup, entries, params));
+}
+auto sys_io_uring_enter(int fd,
+                        unsigned toSubmit,
+                        unsigned minComplete,
+                        unsigned flags) noexcept -> int
+{
+    return static_cast<int>(::syscall(__NR_io_uring_enter, fd, toSubmit,
+                                      minComplete, flags, nullptr, 0));
+}
+auto sys_io_uring_register(int fd,
+                           unsigned opcode,
+                           void const *arg,
+                           unsigned numArgs) noexcept -> int
+{
+    return static_cast<int>(
+            ::syscall(__NR_io_uring_register, fd, opcode, arg, numArgs));
+}
+
+template <typename T>
+auto ring_member(void *ring, std::uint32_t offset) noexcept -> T *
+{
+    return reinterpret_cast<T *>(static_cast<std::byte *>(ring) + offset);
+}
+auto ring_load(unsigned *where) noexcept -> unsigned
+{
+    return std::atomic_ref<unsigned>(*where).load(std::memory_order::acquire);
+}
+void ring_store(unsigned *where, unsigned value) noexcept
+{
+    std::atomic_ref<unsigned>(*where).store(value, std::memory_order::release);
+}
+
+} // namespace
+
+io_uring_queue::~io_uring_queue() noexcept
+{
+    if (mSqes != nullptr)
+    {
+        ::munmap(mSqes, mSqesSize);
+    }
+    if (mCqRing != nullptr && mCqRing != mSqRing)
+    {
+        ::munmap(mCqRing, mCqRingSize);
+    }
+    if (mSqRing != nullptr)
+    {
+        ::munmap(mSqRing, mSqRingSize);
+    }
+    if (mRingFd >= 0)
+    {
+        // closing the ring also unregisters the fixed buffers
+        ::close(mRingFd);
+    }
+}
+
+auto io_uring_queue::create(
+        int const fd,
+        unsigned const queueDepth,
+        std::span<std::byte> const registeredRegion) noexcept
+        -> result<std::unique_ptr<io_uring_queue>>
+{
+    using namespace std::string_view_literals;
+
+    std::unique_ptr<io_uring_queue> self{new (std::nothrow) io_uring_queue()};
+    if (!self)
+    {
+        return errc::not_enough_memory;
+    }
+    self->mFileFd = fd;
+
+    io_uring_params params{};
+    self->mRingFd = sys_io_uring_setup(queueDepth, &params);
+    if (self->mRingFd < 0)
+    {
+        return collect_system_error()
+               << ed::error_code_api_origin{"io_uring_setup"sv};
+    }
+
+    bool const singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    self->mSqRingSize
+            = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    self->mCqRingSize
+            = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    if (singleMmap)
+    {
+        self->mSqRingSize = self->mCqRingSize
+                = std::max(self->mSqRingSize, self->mCqRingSize);
+    }
+
+    void *const sqRing = ::mmap(nullptr, self->mSqRingSize,
+                                PROT_READ | PROT_WRITE,
+                                MAP_SHARED | MAP_POPULATE, self->mRingFd,
+                                IORING_OFF_SQ_RING);
+    if (sqRing == MAP_FAILED)
+    {
+        return collect_system_error() << ed::error_code_api_origin{"mmap"sv};
+    }
+    self->mSqRing = sqRing;
+
+    if (singleMmap)
+    {
+        self->mCqRing = sqRing;
+    }
+    else
+    {
+        void *const cqRing = ::mmap(nullptr, self->mCqRingSize,
+                                    PROT_READ | PROT_WRITE,
+                                    MAP_SHARED | MAP_POPULATE, self->mRingFd,
+                                    IORING_OFF_CQ_RING);
+        if (cqRing == MAP_FAILED)
+        {
+            return collect_system_error()
+                   << ed::error_code_api_origin{"mmap"sv};
+        }
+        self->mCqRing = cqRing;
+    }
+
+    self->mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    void *const sqes = ::mmap(nullptr, self->mSqesSize,
+                              PROT_READ | PROT_WRITE,
+                              MAP_SHARED | MAP_POPULATE, self->mRingFd,
+                              IORING_OFF_SQES);
+    if (sqes == MAP_FAILED)
+    {
+        return collect_system_error() << ed::error_code_api_origin{"mmap"sv};
+    }
+    self->mSqes = sqes;
+
+    self->mSqHead = ring_member<unsigned>(sqRing, params.sq_off.head);
+    self->mSqTail = ring_member<unsigned>(sqRing, params.sq_off.tail);
+    self->mSqArray = ring_member<unsigned>(sqRing, params.sq_off.array);
+    self->mSqMask = *ring_member<unsigned>(sqRing, params.sq_off.ring_mask);
+
+    self->mCqHead = ring_member<unsigned>(self->mCqRing, params.cq_off.head);
+    self->mCqTail = ring_member<unsigned>(self->mCqRing, params.cq_off.tail);
+    self->mCqes = ring_member<io_uring_cqe>(self->mCqRing, params.cq_off.cqes);
+    self->mCqMask
+            = *ring_member<unsigned>(self->mCqRing, params.cq_off.ring_mask);
+
+    self->mCapacity = params.sq_entries;
+
+    if (!registeredRegion.empty())
+    {
+        iovec const region{registeredRegion.data(), registeredRegion.size()};
+        // registration failures only cost us the fixed buffer fast path
+        if (sys_io_uring_register(self->mRingFd, IORING_REGISTER_BUFFERS,
+                                  &region, 1U)
+            == 0)
+        {
+            self->mRegisteredRegion = registeredRegion;
+        }
+    }
+
+    return self;
+}
+
+auto io_uring_queue::read(std::span<buffer_type const> buffers,
+                          std::uint64_t offset) noexcept -> result<void>
+{
+    std::array<operation, max_batch_size> ops;
+    while (!buffers.empty())
+    {
+        auto const batchSize = std::min(
+                {buffers.size(), max_batch_size, std::size_t{mCapacity}});
+        for (std::size_t i = 0U; i < batchSize; ++i)
+        {
+            ops[i].data = buffers[i].data();
+            ops[i].size = buffers[i].size();
+            ops[i].offset = offset;
+            ops[i].write = false;
+            offset += buffers[i].size();
+        }
+        VEFS_TRY(submit_and_wait(std::span(ops).first(batchSize)));
+        buffers = buffers.subspan(batchSize);
+    }
+    return oc::success();
+}
+
+auto io_uring_queue::write(std::span<const_buffer_type const> buffers,
+                           std::uint64_t offset) noexcept -> result<void>
+{
+    std::array<operation, max_batch_size> ops;
+    while (!buffers.empty())
+    {
+        auto const batchSize = std::min(
+                {buffers.size(), max_batch_size, std::size_t{mCapacity}});
+        for (std::size_t i = 0U; i < batchSize; ++i)
+        {
+            ops[i].data = buffers[i].data();
+            ops[i].size = buffers[i].size();
+            ops[i].offset = offset;
+            ops[i].write = true;
+            offset += buffers[i].size();
+        }
+        VEFS_TRY(submit_and_wait(std::span(ops).first(batchSize)));
+        buffers = buffers.subspan(batchSize);
+    }
+    return oc::success();
+}
+
+auto io_uring_queue::write_scattered(
+        std::span<const_buffer_type const> buffers,
+        std::span<std::uint64_t const> offsets) noexcept -> result<void>
+{
+    if (buffers.size() != offsets.size())
+    {
+        return errc::invalid_argument;
+    }
+    std::array<operation, max_batch_size> ops;
+    while (!buffers.empty())
+    {
+        auto const batchSize = std::min(
+                {buffers.size(), max_batch_size, std::size_t{mCapacity}});
+        for (std::size_t i = 0U; i < batchSize; ++i)
+        {
+            ops[i].data = buffers[i].data();
+            ops[i].size = buffers[i].size();
+            ops[i].offset = offsets[i];
+            ops[i].write = true;
+        }
+        VEFS_TRY(submit_and_wait(std::span(ops).first(batchSize)));
+        buffers = buffers.subspan(batchSize);
+        offsets = offsets.subspan(batchSize);
+    }
+    return oc::success();
+}
+
+auto io_uring_queue::submit_and_wait(std::span<operation> ops) noexcept
+        -> result<void>
+{
+    auto const regionBegin
+            = reinterpret_cast<std::uintptr_t>(mRegisteredRegion.data());
+    auto const regionEnd = regionBegin + mRegisteredRegion.size();
+    auto const prepare = [&](operation &op) {
+        auto const begin = reinterpret_cast<std::uintptr_t>(op.data);
+        op.fixed = regionBegin <= begin && begin + op.size <= regionEnd;
+        op.result = 0;
+        op.done.store(false, std::memory_order::relaxed);
+    };
+    std::ranges::for_each(ops, prepare);
+
+    for (auto pending = ops; !pending.empty();)
+    {
+        auto const numOps = static_cast<unsigned>(pending.size());
+        reserve_slots(numOps);
+
+        std::size_t numSubmitted = 0U;
+        auto submitRx = submit(pending, numSubmitted);
+        // the kernel may still write into the buffers of submitted operations
+        // therefore we need to wait for them even if the submission failed
+        wait_for(pending.first(numSubmitted));
+        release_slots(numOps);
+        VEFS_TRY(std::move(submitRx));
+
+        // short transfers are continued with a follow-up operation
+        std::size_t numIncomplete = 0U;
+        for (auto &op : pending)
+        {
+            if (op.result < 0)
+            {
+                return system_error::posix_code(-op.result);
+            }
+            auto const transferred = static_cast<std::size_t>(op.result);
+            if (transferred == op.size)
+            {
+                continue;
+            }
+            if (transferred == 0U)
+            {
+                if (op.write)
+                {
+                    return archive_errc::bad;
+                }
+                return archive_errc::sector_reference_out_of_range;
+            }
+
+            auto const data = op.data + transferred;
+            auto const size = op.size - transferred;
+            auto const offset = op.offset + transferred;
+            auto const write = op.write;
+
+            auto &followUp = pending[numIncomplete++];
+            followUp.data = data;
+            followUp.size = size;
+            followUp.offset = offset;
+            followUp.write = write;
+            prepare(followUp);
+        }
+        pending = pending.first(numIncomplete);
+    }
+    return oc::success();
+}
+
+auto io_uring_queue::submit(std::span<operation> ops,
+                            std::size_t &numSubmitted) noexcept -> result<void>
+{
+    std::lock_guard submissionLock{mSubmissionSync};
+
+    auto *const sqes = static_cast<io_uring_sqe *>(mSqes);
+    // we are the only producer, i.e. the tail can't change under our feet
+    auto tail = *mSqTail;
+    for (auto &op : ops)
+    {
+        auto const index = tail & mSqMask;
+        auto &sqe = sqes[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+
+        if (op.fixed)
+        {
+            sqe.opcode
+                    = op.write ? IORING_OP_WRITE_FIXED : IORING_OP_READ_FIXED;
+            sqe.buf_index = 0U;
+        }
+        else
+        {
+            sqe.opcode = op.write ? IORING_OP_WRITE : IORING_OP_READ;
+        }
+        sqe.fd = mFileFd;
+        sqe.off = op.offset;
+        sqe.addr = reinterpret_cast<std::uintptr_t>(op.data);
+        sqe.len = static_cast<std::uint32_t>(op.size);
+        sqe.user_data = reinterpret_cast<std::uintptr_t>(&op);
+
+        mSqArray[index] = index;
+        ++tail;
+    }
+    ring_store(mSqTail, tail);
+
+    auto toSubmit = static_cast<unsigned>(ops.size());
+    while (toSubmit > 0U)
+    {
+        auto const rc = sys_io_uring_enter(mRingFd, toSubmit, 0U, 0U);
+        if (rc >= 0)
+        {
+            toSubmit -= static_cast<unsigned>(rc);
+            continue;
+        }
+
+        auto const errorCode = errno;
+        if (errorCode == EINTR || errorCode == EAGAIN)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+        // withdraw the entries which haven't been consumed by the kernel, so
+        // that it never observes operations nobody is waiting for
+        ring_store(mSqTail, ring_load(mSqHead));
+        numSubmitted = ops.size() - toSubmit;
+        return system_error::posix_code(errorCode);
+    }
+    numSubmitted = ops.size();
+    return oc::success();
+}
+
+void io_uring_queue::wait_for(std::span<operation const> ops) noexcept
+{
+    for (auto const &op : ops)
+    {
+        while (!op.done.load(std::memory_order::acquire))
+        {
+            std::lock_guard completionLock{mCompletionSync};
+            if (!op.done.load(std::memory_order::acquire))
+            {
+                reap_completions(1U);
+            }
+        }
+    }
+}
+
+void io_uring_queue::reap_completions(unsigned const minComplete) noexcept
+{
+    // we are the only consumer, i.e. the head can't change under our feet
+    auto head = *mCqHead;
+    if (head == ring_load(mCqTail))
+    {
+        // failures (e.g. EINTR) are benign, because the caller simply retries
+        (void)sys_io_uring_enter(mRingFd, 0U, minComplete,
+                                 IORING_ENTER_GETEVENTS);
+    }
+
+    auto const *const cqes = static_cast<io_uring_cqe const *>(mCqes);
+    for (auto const tail = ring_load(mCqTail); head != tail; ++head)
+    {
+        auto const &cqe = cqes[head & mCqMask];
+        auto *const op = reinterpret_cast<operation *>(
+                static_cast<std::uintptr_t>(cqe.user_data));
+
+        op->result = cqe.res;
+        // the owner may destroy the operation as soon as it observes this
+        op->done.store(true, std::memory_order::release);
+    }
+    ring_store(mCqHead, head);
+}
+
+void io_uring_queue::reserve_slots(unsigned const num) noexcept
+{
+    std::unique_lock inFlightLock{mInFlightSync};
+    mInFlightCondition.wait(inFlightLock,
+                            [&] { return mNumInFlight + num <= mCapacity; });
+    mNumInFlight += num;
+}
+
+void io_uring_queue::release_slots(unsigned const num) noexcept
+{
+    {
+        std::lock_guard inFlightLock{mInFlightSync};
+        mNumInFlight -= num;
+    }
+    mInFlightCondition.notify_all();
+}
+
+#else
+
+io_uring_queue::~io_uring_queue() noexcept = default;
+
+auto io_uring_queue::create(int, unsigned, std::span<std::byte>) noexcept
+        -> result<std::unique_ptr<io_uring_queue>>
+{
+    return errc::not_supported;
+}
+
+auto io_uring_queue::read(std::span<buffer_type const>, std::uint64_t) noexcept
+        -> result<void>
+{
+    return errc::not_supported;
+}
+
+auto io_uring_queue::write(std::span<const_buffer_type const>,
+                           std::uint64_t) noexcept -> result<void>
+{
+    return errc::not_supported;
+}
+
+auto io_uring_queue::write_scattered(std::span<const_buffer_type const>,
+                                     std::span<std::uint64_t const>) noexcept
+        -> result<void>
+{
+    return errc::not_supported;
+}
+
+#endif
+
+} // namespace vefs::detail
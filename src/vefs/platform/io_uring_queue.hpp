@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <span>
+
+#include <vefs/disappointment.hpp>
+#include <vefs/llfio.hpp>
+
+namespace vefs::detail
+{
+
+/**
+ * @brief A minimal io_uring submission/completion queue pair which allows
+ * many threads to have positional file reads and writes in flight at once.
+ *
+ * Callers submit their requests and then cooperatively reap completions, i.e.
+ * whichever waiting thread holds the completion lock drains the completion
+ * queue on behalf of everyone else. Buffers which lie within the registered
+ * region are transferred with the fixed buffer opcodes.
+ *
+ * The queue is only functional on Linux; creation fails with
+ * errc::not_supported on every other platform.
+ */
+class io_uring_queue
+{
+public:
+    using buffer_type = llfio::file_handle::buffer_type;
+    using const_buffer_type = llfio::file_handle::const_buffer_type;
+
+    ~io_uring_queue() noexcept;
+
+    io_uring_queue(io_uring_queue const &) = delete;
+    auto operator=(io_uring_queue const &) -> io_uring_queue & = delete;
+
+    /**
+     * @param fd the file descriptor every operation is issued against
+     * @param queueDepth the number of submission queue entries
+     * @param registeredRegion memory which is registered with the kernel as
+     *        a single fixed buffer; registration is skipped if it is empty or
+     *        refused by the kernel (e.g. due to RLIMIT_MEMLOCK).
+     */
+    static auto create(int fd,
+                       unsigned queueDepth,
+                       std::span<std::byte> registeredRegion) noexcept
+            -> result<std::unique_ptr<io_uring_queue>>;
+
+    /**
+     * @brief Reads consecutive file bytes starting at offset into the given
+     * buffers. A read hitting the end of file is reported as
+     * archive_errc::sector_reference_out_of_range.
+     */
+    auto read(std::span<buffer_type const> buffers,
+              std::uint64_t offset) noexcept -> result<void>;
+    /**
+     * @brief Writes the given buffers consecutively starting at offset.
+     */
+    auto write(std::span<const_buffer_type const> buffers,
+               std::uint64_t offset) noexcept -> result<void>;
+    /**
+     * @brief Writes each buffer to its own offset, i.e. offsets must have
+     * as many elements as buffers.
+     */
+    auto write_scattered(std::span<const_buffer_type const> buffers,
+                         std::span<std::uint64_t const> offsets) noexcept
+            -> result<void>;
+
+private:
+    struct operation;
+
+    //! upper bound of operations issued by a single submit_and_wait() call
+    static constexpr std::size_t max_batch_size = 32U;
+
+    io_uring_queue() noexcept = default;
+
+    auto submit_and_wait(std::span<operation> ops) noexcept -> result<void>;
+    auto submit(std::span<operation> ops, std::size_t &numSubmitted) noexcept
+            -> result<void>;
+    void wait_for(std::span<operation const> ops) noexcept;
+    void reap_completions(unsigned minComplete) noexcept;
+
+    void reserve_slots(unsigned num) noexcept;
+    void release_slots(unsigned num) noexcept;
+
+    int mRingFd{-1};
+    int mFileFd{-1};
+    std::span<std::byte> mRegisteredRegion{};
+
+    void *mSqRing{nullptr};
+    std::size_t mSqRingSize{};
+    void *mCqRing{nullptr};
+    std::size_t mCqRingSize{};
+    void *mSqes{nullptr};
+    std::size_t mSqesSize{};
+
+    unsigned *mSqHead{nullptr};
+    unsigned *mSqTail{nullptr};
+    unsigned *mSqArray{nullptr};
+    unsigned mSqMask{};
+    unsigned *mCqHead{nullptr};
+    unsigned *mCqTail{nullptr};
+    void *mCqes{nullptr};
+    unsigned mCqMask{};
+
+    // the number of in flight operations is limited to the submission queue
+    // depth which guarantees that the completion queue never overflows
+    unsigned mCapacity{};
+    unsigned mNumInFlight{};
+    std::mutex mInFlightSync;
+    std::condition_variable mInFlightCondition;
+
+    std::mutex mSubmissionSync;
+    std::mutex mCompletionSync;
+};
+
+} // namespace vefs::detail
@@ -0,0 +1,231 @@
+#include "page_allocator.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <boost/predef/os.h>
+
+#if defined BOOST_OS_WINDOWS_AVAILABLE
+#include "windows-proper.h"
+#elif defined BOOST_OS_LINUX_AVAILABLE
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace vefs::detail
+{
+
+namespace
+{
+
+constexpr auto round_up(std::size_t const size,
+                        std::size_t const alignment) noexcept -> std::size_t
+{
+    return (size + alignment - 1U) / alignment * alignment;
+}
+
+} // namespace
+
+#if defined BOOST_OS_LINUX_AVAILABLE
+
+namespace
+{
+
+// the PMD sized huge pages of x86-64 and of arm64 with 4 KiB granules
+constexpr std::size_t huge_page_size = std::size_t{2} << 20;
+// see <linux/mempolicy.h>
+constexpr int mpol_preferred = 1;
+
+auto mapping_size(std::size_t const size, bool const hugePages) noexcept
+        -> std::size_t
+{
+    return round_up(size, hugePages
+                                  ? huge_page_size
+                                  : static_cast<std::size_t>(
+                                          ::sysconf(_SC_PAGESIZE)));
+}
+
+auto map_transparent_huge_pages(std::size_t const size) noexcept -> void *
+{
+    // transparent huge pages require a huge page aligned mapping, therefore
+    // we over-allocate and trim the excess
+    auto const reserved = size + huge_page_size;
+    void *const mapping = ::mmap(nullptr, reserved, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping == MAP_FAILED)
+    {
+        return nullptr;
+    }
+    auto *const first = static_cast<std::byte *>(mapping);
+    auto *const aligned = first
+                          + (round_up(reinterpret_cast<std::uintptr_t>(first),
+                                      huge_page_size)
+                             - reinterpret_cast<std::uintptr_t>(first));
+    if (aligned != first)
+    {
+        ::munmap(first, static_cast<std::size_t>(aligned - first));
+    }
+    if (auto const tail = first + reserved - (aligned + size); tail > 0)
+    {
+        ::munmap(aligned + size, static_cast<std::size_t>(tail));
+    }
+    // failure only means that the mapping is backed by regular pages
+    (void)::madvise(aligned, size, MADV_HUGEPAGE);
+    return aligned;
+}
+
+} // namespace
+
+auto map_pages(std::size_t size,
+               bool const hugePages,
+               int const numaNode) noexcept -> void *
+{
+    size = mapping_size(size, hugePages);
+
+    void *mapping = MAP_FAILED;
+    if (hugePages)
+    {
+        mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (mapping == MAP_FAILED)
+        {
+            // the explicit huge page pool is exhausted or not configured
+            mapping = map_transparent_huge_pages(size);
+        }
+    }
+    else
+    {
+        mapping = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    }
+    if (mapping == MAP_FAILED || mapping == nullptr)
+    {
+        return nullptr;
+    }
+
+    constexpr int bitsPerMask = sizeof(unsigned long) * 8;
+    if (numaNode >= 0 && numaNode < bitsPerMask)
+    {
+        // the pages haven't been touched yet, i.e. the policy applies to all
+        // of them; libnuma isn't required for a single system call
+        unsigned long const nodeMask = 1UL << numaNode;
+        (void)::syscall(SYS_mbind, mapping, size, mpol_preferred, &nodeMask,
+                        static_cast<unsigned long>(bitsPerMask), 0U);
+    }
+    return mapping;
+}
+
+void unmap_pages(void *const pages,
+                 std::size_t const size,
+                 bool const hugePages) noexcept
+{
+    ::munmap(pages, mapping_size(size, hugePages));
+}
+
+auto num_numa_nodes() noexcept -> unsigned
+{
+    // e.g. "0" or "0-3"; the last number is the highest node id
+    std::FILE *const possible
+            = std::fopen("/sys/devices/system/node/possible", "r");
+    if (possible == nullptr)
+    {
+        return 1U;
+    }
+    unsigned highest = 0U;
+    for (int ch; (ch = std::fgetc(possible)) != EOF;)
+    {
+        if (ch >= '0' && ch <= '9')
+        {
+            highest = highest * 10U + static_cast<unsigned>(ch - '0');
+        }
+        else if (ch == '-' || ch == ',')
+        {
+            highest = 0U;
+        }
+    }
+    std::fclose(possible);
+    return highest + 1U;
+}
+
+#elif defined BOOST_OS_WINDOWS_AVAILABLE
+
+auto map_pages(std::size_t size,
+               bool const hugePages,
+               int const numaNode) noexcept -> void *
+{
+    DWORD const preferredNode = numaNode >= 0
+                                        ? static_cast<DWORD>(numaNode)
+                                        : NUMA_NO_PREFERRED_NODE;
+    if (hugePages)
+    {
+        // large pages require the SeLockMemoryPrivilege
+        if (auto const largePageSize = ::GetLargePageMinimum();
+            largePageSize != 0U)
+        {
+            if (void *const mapping = ::VirtualAllocExNuma(
+                        ::GetCurrentProcess(), nullptr,
+                        round_up(size, largePageSize),
+                        MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+                        PAGE_READWRITE, preferredNode))
+            {
+                return mapping;
+            }
+        }
+    }
+    return ::VirtualAllocExNuma(::GetCurrentProcess(), nullptr, size,
+                                MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE,
+                                preferredNode);
+}
+
+void unmap_pages(void *const pages, std::size_t, bool) noexcept
+{
+    ::VirtualFree(pages, 0U, MEM_RELEASE);
+}
+
+auto num_numa_nodes() noexcept -> unsigned
+{
+    ULONG highest = 0U;
+    if (!::GetNumaHighestNodeNumber(&highest))
+    {
+        return 1U;
+    }
+    return static_cast<unsigned>(highest) + 1U;
+}
+
+#else
+
+namespace
+{
+
+constexpr std::size_t fallback_alignment = 4096U;
+
+} // namespace
+
+auto map_pages(std::size_t size, bool, int) noexcept -> void *
+{
+    void *const mapping = ::operator new(round_up(size, fallback_alignment),
+                                         std::align_val_t{fallback_alignment},
+                                         std::nothrow);
+    if (mapping != nullptr)
+    {
+        std::memset(mapping, 0, size);
+    }
+    return mapping;
+}
+
+void unmap_pages(void *const pages, std::size_t const size, bool) noexcept
+{
+    ::operator delete(pages, round_up(size, fallback_alignment),
+                      std::align_val_t{fallback_alignment});
+}
+
+auto num_numa_nodes() noexcept -> unsigned
+{
+    return 1U;
+}
+
+#endif
+
+} // namespace vefs::detail
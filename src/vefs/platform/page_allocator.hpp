@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+
+#include <limits>
+#include <new>
+
+namespace vefs::detail
+{
+
+//! page_allocator::numa_node() value which leaves the placement to the system
+inline constexpr int no_numa_node = -1;
+//! page_allocator::numa_node() value which spreads the storage of the shards
+//! of a cache round robin over all NUMA nodes, see page_allocator::for_shard()
+inline constexpr int interleave_numa_nodes = -2;
+
+/**
+ * @brief Maps zero initialized memory directly from the operating system.
+ *
+ * The mapping is backed by huge pages if requested and possible; explicit
+ * huge pages are tried before transparent ones. A non-negative numaNode is
+ * a placement preference, i.e. the mapping doesn't fail if the node can't
+ * satisfy it.
+ *
+ * @return nullptr if the memory couldn't be mapped
+ */
+auto map_pages(std::size_t size, bool hugePages, int numaNode) noexcept
+        -> void *;
+//! unmaps memory obtained by map_pages() with the same size and hugePages
+void unmap_pages(void *pages, std::size_t size, bool hugePages) noexcept;
+
+//! the number of NUMA nodes of the system; at least 1
+auto num_numa_nodes() noexcept -> unsigned;
+
+/**
+ * @brief An allocator which maps large allocations directly from the
+ *        operating system in order to back them with huge pages and/or to
+ *        place them on a NUMA node.
+ *
+ * Allocations smaller than min_mapping_size or without any placement
+ * requirements are forwarded to operator new, i.e. a default constructed
+ * page_allocator behaves like std::allocator.
+ */
+template <typename T>
+class page_allocator
+{
+    template <typename>
+    friend class page_allocator;
+
+    bool mHugePages;
+    int mNumaNode;
+
+public:
+    using value_type = T;
+
+    //! the minimum number of bytes of an allocation to be mapped
+    static constexpr std::size_t min_mapping_size = std::size_t{1} << 20;
+
+    constexpr page_allocator() noexcept
+        : mHugePages(false)
+        , mNumaNode(no_numa_node)
+    {
+    }
+    constexpr page_allocator(bool const hugePages, int const numaNode) noexcept
+        : mHugePages(hugePages)
+        , mNumaNode(numaNode)
+    {
+    }
+    template <typename U>
+    constexpr page_allocator(page_allocator<U> const &other) noexcept
+        : mHugePages(other.mHugePages)
+        , mNumaNode(other.mNumaNode)
+    {
+    }
+
+    auto huge_pages() const noexcept -> bool
+    {
+        return mHugePages;
+    }
+    auto numa_node() const noexcept -> int
+    {
+        return mNumaNode;
+    }
+
+    /**
+     * @brief Derives the allocator of the given cache shard which resolves
+     *        interleave_numa_nodes to a concrete node.
+     */
+    auto for_shard(unsigned const shard) const noexcept -> page_allocator
+    {
+        auto derived = *this;
+        if (mNumaNode == interleave_numa_nodes)
+        {
+            derived.mNumaNode = static_cast<int>(shard % num_numa_nodes());
+        }
+        return derived;
+    }
+
+    [[nodiscard]] auto allocate(std::size_t const n) -> T *
+    {
+        if (n > std::numeric_limits<std::size_t>::max() / sizeof(T))
+        {
+            throw std::bad_array_new_length();
+        }
+        auto const size = n * sizeof(T);
+        if (!maps(size))
+        {
+            return static_cast<T *>(
+                    ::operator new(size, std::align_val_t{alignof(T)}));
+        }
+        if (void *const pages = map_pages(size, mHugePages, mNumaNode))
+        {
+            return static_cast<T *>(pages);
+        }
+        throw std::bad_alloc();
+    }
+    void deallocate(T *const p, std::size_t const n) noexcept
+    {
+        auto const size = n * sizeof(T);
+        if (!maps(size))
+        {
+            ::operator delete(p, size, std::align_val_t{alignof(T)});
+        }
+        else
+        {
+            unmap_pages(p, size, mHugePages);
+        }
+    }
+
+    friend constexpr auto operator==(page_allocator const &,
+                                     page_allocator const &) noexcept -> bool
+            = default;
+
+private:
+    auto maps(std::size_t const size) const noexcept -> bool
+    {
+        return (mHugePages || mNumaNode >= 0) && size >= min_mapping_size;
+    }
+};
+
+} // namespace vefs::detail
@@ -10,14 +10,26 @@ namespace vefs
 
 vfile::vfile(vfilesystem *owner,
              detail::thread_pool &executor,
+             detail::cache_budget &cacheBudget,
+             tree_type::sector_cache *sharedCache,
+             cache_policy cachePolicy,
              detail::file_id id,
              std::uint64_t maximumExtent,
+             std::uint64_t desiredCachePages,
              inacessible_ctor)
     : mOwner(owner)
     , mId(id)
+    , mCacheBudget(cacheBudget)
+    , mSharedCache(sharedCache)
+    , mCachePolicy(cachePolicy)
+    , mNumCachePages(sharedCache != nullptr
+                             ? 0U
+                             : cacheBudget.acquire(desiredCachePages))
     , mFileTree()
     , mMaximumExtent(maximumExtent)
     , mWriteFlag()
+    , mSequentialReadPos(0U)
+    , mReadAheadEnd(0U)
     , mFileSemaphore(1)
     , mCommitSync()
     , mWorkTracker(&executor)
@@ -31,11 +43,15 @@ vfile::~vfile()
         mWorkTracker.wait();
         mFileTree.reset();
     }
+    mCacheBudget.release(mNumCachePages);
 }
 
 auto vfile::open_existing(vfilesystem *owner,
                           detail::thread_pool &executor,
                           detail::archive_sector_allocator &allocator,
+                          detail::cache_budget &cacheBudget,
+                          tree_type::sector_cache *sharedCache,
+                          cache_policy cachePolicy,
                           detail::file_id id,
                           detail::sector_device &device,
                           detail::file_crypto_ctx &cryptoCtx,
@@ -44,7 +60,10 @@ auto vfile::open_existing(vfilesystem *owner,
 try
 {
     auto self = std::make_shared<vfile>(
-            owner, executor, id, treeRoot.maximum_extent, inacessible_ctor{});
+            owner, executor, cacheBudget, sharedCache, cachePolicy, id,
+            treeRoot.maximum_extent,
+            detail::lut::required_sector_count(treeRoot.maximum_extent),
+            inacessible_ctor{});
 
     VEFS_TRY(self->open_existing(device, cryptoCtx, allocator, treeRoot));
 
@@ -60,8 +79,24 @@ auto vfile::open_existing(detail::sector_device &device,
                           detail::archive_sector_allocator &allocator,
                           detail::root_sector_info treeRoot) -> result<void>
 {
-    VEFS_TRY(mFileTree,
-             tree_type::open_existing(device, cryptoCtx, treeRoot, allocator));
+    if (mSharedCache != nullptr)
+    {
+        VEFS_TRY(mFileTree,
+                 tree_type::open_existing(device, cryptoCtx, treeRoot,
+                                          *mSharedCache, allocator));
+    }
+    else
+    {
+        if (mNumCachePages == 0U)
+        {
+            // the cache budget is exhausted
+            return errc::not_enough_memory;
+        }
+        VEFS_TRY(mFileTree,
+                 tree_type::open_existing(device, cryptoCtx, treeRoot,
+                                          mNumCachePages, mCachePolicy,
+                                          allocator));
+    }
 
     return success();
 }
@@ -69,14 +104,19 @@ auto vfile::open_existing(detail::sector_device &device,
 auto vfile::create_new(vfilesystem *owner,
                        detail::thread_pool &executor,
                        detail::archive_sector_allocator &allocator,
+                       detail::cache_budget &cacheBudget,
+                       tree_type::sector_cache *sharedCache,
+                       cache_policy cachePolicy,
                        detail::file_id id,
                        detail::sector_device &device,
                        detail::file_crypto_ctx &cryptoCtx)
         -> result<std::shared_ptr<vfile>>
 try
 {
-    auto self = std::make_shared<vfile>(owner, executor, id, 0,
-                                        inacessible_ctor{});
+    auto self = std::make_shared<vfile>(owner, executor, cacheBudget,
+                                        sharedCache, cachePolicy, id, 0,
+                                        // i.e. min_file_cache_size
+                                        0U, inacessible_ctor{});
 
     VEFS_TRY(self->create_new(device, allocator, cryptoCtx));
 
@@ -91,7 +131,22 @@ auto vfile::create_new(detail::sector_device &device,
                        detail::archive_sector_allocator &allocator,
                        detail::file_crypto_ctx &cryptoCtx) -> result<void>
 {
-    VEFS_TRY(mFileTree, tree_type::create_new(device, cryptoCtx, allocator));
+    if (mSharedCache != nullptr)
+    {
+        VEFS_TRY(mFileTree, tree_type::create_new(device, cryptoCtx,
+                                                  *mSharedCache, allocator));
+    }
+    else
+    {
+        if (mNumCachePages == 0U)
+        {
+            // the cache budget is exhausted
+            return errc::not_enough_memory;
+        }
+        VEFS_TRY(mFileTree,
+                 tree_type::create_new(device, cryptoCtx, mNumCachePages,
+                                       mCachePolicy, allocator));
+    }
 
     mWriteFlag.mark();
     return success();
@@ -99,9 +154,56 @@ auto vfile::create_new(detail::sector_device &device,
 
 auto vfile::read(rw_dynblob buffer, std::uint64_t readPos) -> result<void>
 {
+    auto const readEnd = readPos + buffer.size();
+    if (mSequentialReadPos.exchange(readEnd, std::memory_order::relaxed)
+        == readPos)
+    {
+        // the prefetches overlap with the synchronous read below
+        schedule_read_ahead(readEnd);
+    }
     return detail::read(*mFileTree, buffer, readPos);
 }
 
+void vfile::schedule_read_ahead(std::uint64_t const readEnd) noexcept
+{
+    using detail::lut::sector_position_of;
+
+    auto const maximumExtent = mMaximumExtent.load(std::memory_order_acquire);
+    if (readEnd >= maximumExtent)
+    {
+        return;
+    }
+    auto const first = sector_position_of(readEnd);
+    auto const last = std::min(first + read_ahead_window,
+                               sector_position_of(maximumExtent - 1) + 1);
+
+    // only prefetch the part of the window which hasn't been issued yet
+    std::uint64_t begin;
+    auto issued = mReadAheadEnd.load(std::memory_order::relaxed);
+    do
+    {
+        begin = issued >= first && issued <= last ? issued : first;
+        if (begin >= last)
+        {
+            return;
+        }
+    }
+    while (!mReadAheadEnd.compare_exchange_weak(issued, last,
+                                                std::memory_order::relaxed));
+
+    try
+    {
+        // failures are ignored, the actual read will report them
+        mWorkTracker.execute([this, begin, last] {
+            (void)mFileTree->prefetch(begin, last);
+        });
+    }
+    catch (std::bad_alloc const &)
+    {
+        // read-ahead is merely an optimization
+    }
+}
+
 auto vfile::write(ro_dynblob data, std::uint64_t writePos) -> result<void>
 {
     if (auto maxExtent = mMaximumExtent.load(std::memory_order_acquire);
@@ -127,7 +229,8 @@ auto vfile::write(ro_dynblob data, std::uint64_t writePos) -> result<void>
 auto vefs::vfile::extract(llfio::file_handle &fileHandle) -> result<void>
 {
     return detail::extract(*mFileTree, fileHandle, 0,
-                           mMaximumExtent.load(std::memory_order_acquire));
+                           mMaximumExtent.load(std::memory_order_acquire),
+                           mWorkTracker);
 }
 
 auto vfile::maximum_extent() -> std::uint64_t
@@ -10,6 +10,7 @@
 
 #include "detail/archive_file_id.hpp"
 #include "detail/archive_sector_allocator.hpp"
+#include "detail/cache_budget.hpp"
 #include "detail/cow_tree_allocator_mt.hpp"
 #include "detail/root_sector_info.hpp"
 #include "detail/sector_tree_mt.hpp"
@@ -35,22 +36,42 @@ class vfile
 public:
     vfile(vfilesystem *owner,
           detail::thread_pool &executor,
+          detail::cache_budget &cacheBudget,
+          tree_type::sector_cache *sharedCache,
+          cache_policy cachePolicy,
           detail::file_id id,
           std::uint64_t maximumExtent,
+          std::uint64_t desiredCachePages,
           inacessible_ctor);
     ~vfile();
 
+    /**
+     * The sector cache of the opened file is sized after its current
+     * maximum extent within the limits of the given cache budget unless
+     * a shared cache is supplied. Fails with errc::not_enough_memory if the
+     * budget is exhausted.
+     */
     static auto open_existing(vfilesystem *owner,
                               detail::thread_pool &executor,
                               detail::archive_sector_allocator &allocator,
+                              detail::cache_budget &cacheBudget,
+                              tree_type::sector_cache *sharedCache,
+                              cache_policy cachePolicy,
                               detail::file_id id,
                               detail::sector_device &device,
                               detail::file_crypto_ctx &cryptoCtx,
                               detail::root_sector_info treeRoot)
             -> result<std::shared_ptr<vfile>>;
+    /**
+     * A new file is expected to grow, therefore its sector cache reserves
+     * the tree's default cache size from the budget.
+     */
     static auto create_new(vfilesystem *owner,
                            detail::thread_pool &executor,
                            detail::archive_sector_allocator &allocator,
+                           detail::cache_budget &cacheBudget,
+                           tree_type::sector_cache *sharedCache,
+                           cache_policy cachePolicy,
                            detail::file_id id,
                            detail::sector_device &device,
                            detail::file_crypto_ctx &cryptoCtx)
@@ -69,6 +90,16 @@ public:
     auto truncate(std::uint64_t size) -> result<void>;
 
     auto commit() -> result<void>;
+    //! the statistics of the sector cache used by this vfile
+    auto cache_stats() const noexcept -> vefs::cache_stats
+    {
+        return mFileTree->cache_stats();
+    }
+    //! the number of pages of the sector cache used by this vfile
+    auto cache_size() const noexcept -> std::uint32_t
+    {
+        return mFileTree->cache_size();
+    }
     auto is_dirty() -> bool
     {
         return mWriteFlag.is_dirty();
@@ -101,13 +132,35 @@ private:
     auto sync_commit_info(detail::root_sector_info committedRootInfo) noexcept
             -> result<void>;
 
+    /**
+     * Loads the leaf sectors following readEnd into the sector cache on
+     * the work tracker, so that a sequential reader finds them decrypted.
+     * Adjacent sectors are read with a single vectored read.
+     */
+    void schedule_read_ahead(std::uint64_t readEnd) noexcept;
+
+    //! the number of leaf sectors prefetched ahead of a sequential reader
+    static constexpr std::uint64_t read_ahead_window = 8U;
+
     vfilesystem *mOwner;
     detail::file_id mId;
 
+    detail::cache_budget &mCacheBudget;
+    // the archive wide sector cache if any, otherwise the tree owns a cache
+    tree_type::sector_cache *mSharedCache;
+    cache_policy mCachePolicy;
+    // the number of pages reserved from mCacheBudget for the sector cache
+    std::uint32_t mNumCachePages;
+
     std::unique_ptr<tree_type> mFileTree;
     std::atomic<std::uint64_t> mMaximumExtent;
     utils::dirt_flag mWriteFlag;
 
+    // the read position expected if the reader is sequential
+    std::atomic<std::uint64_t> mSequentialReadPos;
+    // the leaf position up to which prefetches have been issued (exclusive)
+    std::atomic<std::uint64_t> mReadAheadEnd;
+
     std::binary_semaphore mFileSemaphore;
     std::mutex mCommitSync;
     detail::pooled_work_tracker mWorkTracker;
@@ -1,5 +1,11 @@
 #include "vfilesystem.hpp"
 
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include <boost/container/small_vector.hpp>
 #include <boost/endian/conversion.hpp>
 
@@ -634,10 +640,18 @@ private:
 vfilesystem::vfilesystem(detail::sector_device &device,
                          detail::archive_sector_allocator &allocator,
                          detail::thread_pool &executor,
-                         detail::master_file_info const &info)
+                         detail::master_file_info const &info,
+                         archive_options const &options)
     : mDevice(device)
     , mSectorAllocator(allocator)
     , mDeviceExecutor(executor)
+    , mCacheBudget(options.cache_budget.value_or(
+                           archive_options::default_cache_budget),
+                   options.min_file_cache_size,
+                   detail::sector_device::sector_size,
+                   options.cache_budget.has_value())
+    , mSharedCache()
+    , mCachePolicy(options.eviction_policy)
     , mCryptoCtx(info.crypto_state)
     , mCommittedRoot(info.tree_info)
     , mIndex(1024U)
@@ -652,26 +666,35 @@ vfilesystem::vfilesystem(detail::sector_device &device,
 auto vfilesystem::open_existing(detail::sector_device &device,
                                 detail::archive_sector_allocator &allocator,
                                 detail::thread_pool &executor,
-                                detail::master_file_info const &info)
+                                detail::master_file_info const &info,
+                                archive_options const &options)
         -> result<std::unique_ptr<vfilesystem>>
 {
-    std::unique_ptr<vfilesystem> self{
-            new (std::nothrow) vfilesystem(device, allocator, executor, info)};
+    std::unique_ptr<vfilesystem> self{new (std::nothrow) vfilesystem(
+            device, allocator, executor, info, options)};
 
     if (!self)
     {
         return errc::not_enough_memory;
     }
 
-    VEFS_TRY(self->open_existing_impl());
+    VEFS_TRY(self->open_existing_impl(options));
 
     return self;
 }
 
-auto vfilesystem::open_existing_impl() -> result<void>
+auto vfilesystem::open_existing_impl(archive_options const &options)
+        -> result<void>
 {
-    if (auto openTreeRx = tree_type::open_existing(
-                mDevice, mCryptoCtx, mCommittedRoot, mSectorAllocator))
+    VEFS_TRY(create_shared_cache(options));
+    if (auto openTreeRx
+        = mSharedCache ? tree_type::open_existing(mDevice, mCryptoCtx,
+                                                  mCommittedRoot, *mSharedCache,
+                                                  mSectorAllocator)
+                       : tree_type::open_existing(
+                               mDevice, mCryptoCtx, mCommittedRoot,
+                               tree_type::default_cache_size,
+                               options.eviction_policy, mSectorAllocator))
     {
         mIndexTree = std::move(openTreeRx).assume_value();
     }
@@ -699,26 +722,34 @@ auto vfilesystem::open_existing_impl() -> result<void>
 auto vfilesystem::create_new(detail::sector_device &device,
                              detail::archive_sector_allocator &allocator,
                              detail::thread_pool &executor,
-                             detail::master_file_info const &info)
+                             detail::master_file_info const &info,
+                             archive_options const &options)
         -> result<std::unique_ptr<vfilesystem>>
 {
-    std::unique_ptr<vfilesystem> self{
-            new (std::nothrow) vfilesystem(device, allocator, executor, info)};
+    std::unique_ptr<vfilesystem> self{new (std::nothrow) vfilesystem(
+            device, allocator, executor, info, options)};
 
     if (!self)
     {
         return errc::not_enough_memory;
     }
 
-    VEFS_TRY(self->create_new_impl());
+    VEFS_TRY(self->create_new_impl(options));
 
     return self;
 }
 
-auto vfilesystem::create_new_impl() -> result<void>
+auto vfilesystem::create_new_impl(archive_options const &options)
+        -> result<void>
 {
+    VEFS_TRY(create_shared_cache(options));
     if (auto createTreeRx
-        = tree_type::create_new(mDevice, mCryptoCtx, mSectorAllocator))
+        = mSharedCache ? tree_type::create_new(mDevice, mCryptoCtx,
+                                               *mSharedCache, mSectorAllocator)
+                       : tree_type::create_new(mDevice, mCryptoCtx,
+                                               tree_type::default_cache_size,
+                                               options.eviction_policy,
+                                               mSectorAllocator))
     {
         mIndexTree = std::move(createTreeRx).assume_value();
     }
@@ -735,6 +766,32 @@ auto vfilesystem::create_new_impl() -> result<void>
     return success();
 }
 
+auto vfilesystem::create_shared_cache(archive_options const &options)
+        -> result<void>
+{
+    if (!options.shared_sector_cache)
+    {
+        return success();
+    }
+    // the shared cache claims the whole budget, i.e. the vfiles won't draw
+    // from it
+    auto const numCachePages = mCacheBudget.acquire(
+            options.cache_budget.value_or(archive_options::default_cache_budget)
+            / detail::sector_device::sector_size);
+    if (numCachePages == 0U)
+    {
+        // the budget can't even accommodate min_file_cache_size
+        return errc::invalid_argument;
+    }
+    static_assert(cache_numa_interleave == detail::interleave_numa_nodes);
+    tree_type::sector_cache_allocator const cacheAllocator(
+            options.huge_page_cache, options.cache_numa_node);
+    VEFS_TRY(mSharedCache,
+             tree_type::create_cache(numCachePages, options.eviction_policy,
+                                     cacheAllocator));
+    return success();
+}
+
 auto vfilesystem::open(std::string_view const filePath,
                        file_open_mode_bitset const mode) -> result<vfile_handle>
 {
@@ -752,8 +809,9 @@ auto vfilesystem::open(std::string_view const filePath,
         VEFS_TRY(auto &&secrets, mDevice.create_file_secrets());
 
         VEFS_TRY(auto const fid, file_id::generate());
-        rx = vfile::create_new(this, mDeviceExecutor, mSectorAllocator, fid,
-                               mDevice, *secrets);
+        rx = vfile::create_new(this, mDeviceExecutor, mSectorAllocator,
+                               mCacheBudget, mSharedCache.get(), mCachePolicy,
+                               fid, mDevice, *secrets);
         if (!rx)
         {
             return rx;
@@ -796,8 +854,10 @@ auto vfilesystem::open(detail::file_id const id) -> result<vfile_handle>
             rx = h;
             return;
         }
-        rx = vfile::open_existing(this, mDeviceExecutor, mSectorAllocator, id,
-                                  mDevice, *e.crypto_ctx, e.tree_info);
+        rx = vfile::open_existing(this, mDeviceExecutor, mSectorAllocator,
+                                  mCacheBudget, mSharedCache.get(),
+                                  mCachePolicy, id, mDevice, *e.crypto_ctx,
+                                  e.tree_info);
         if (rx)
         {
             e.instance = rx.assume_value();
@@ -909,14 +969,69 @@ auto vfilesystem::extract(llfio::path_view sourceFilePath,
 
 auto vfilesystem::extractAll(llfio::path_view targetBasePath) -> result<void>
 {
-    for (auto const &indexEntry : mIndex.lock_table())
+    // the index is only locked while taking a snapshot, i.e. the (lengthy)
+    // extraction doesn't block concurrent file operations
+    std::vector<std::pair<std::string, detail::file_id>> entries;
     {
-        VEFS_TRY(extract(indexEntry.first, targetBasePath,
-                         [this, &indexEntry]() -> result<vfile_handle> {
-                             return open(indexEntry.second);
-                         }));
+        auto lockedIndex = mIndex.lock_table();
+        entries.assign(lockedIndex.begin(), lockedIndex.end());
     }
-    return success();
+
+    // the extractors share the executor with their sector loads; they run
+    // the loads which haven't been picked up yet themselves instead of
+    // waiting for them, i.e. they can't starve the executor, but we leave
+    // some workers for loading ahead anyway
+    auto const numExtractors = std::min<std::size_t>(
+            std::max(1U, std::thread::hardware_concurrency() / 2U),
+            entries.size());
+
+    std::atomic<std::size_t> nextEntry{0U};
+    std::mutex failureSync;
+    result<void> failure = success();
+
+    auto const extractEntries = [&]() {
+        for (std::size_t i;
+             (i = nextEntry.fetch_add(1U, std::memory_order_relaxed))
+             < entries.size();)
+        {
+            auto const &entry = entries[i];
+            auto extractrx = extract(entry.first, targetBasePath,
+                                     [this, &entry]() -> result<vfile_handle> {
+                                         return open(entry.second);
+                                     });
+            if (extractrx.has_error())
+            {
+                std::lock_guard failureLock{failureSync};
+                if (!failure.has_error())
+                {
+                    failure = std::move(extractrx);
+                }
+                // skip the remaining entries
+                nextEntry.store(entries.size(), std::memory_order_relaxed);
+            }
+        }
+    };
+
+    std::vector<std::future<void>> extractors;
+    VEFS_SCOPE_EXIT
+    {
+        for (auto &extractor : extractors)
+        {
+            extractor.wait();
+        }
+    };
+    for (std::size_t i = 1U; i < numExtractors; ++i)
+    {
+        extractors.push_back(mDeviceExecutor.twoway_execute(extractEntries));
+    }
+    // the calling thread participates, too
+    extractEntries();
+
+    for (auto &extractor : extractors)
+    {
+        extractor.get();
+    }
+    return failure;
 }
 
 auto vfilesystem::query(std::string_view const filePath)
@@ -963,6 +1078,9 @@ auto vfilesystem::commit() -> result<void>
     {
         return success();
     }
+    // the vfiles published their new roots before releasing the sectors of
+    // the old ones, i.e. the index synchronized below doesn't reference them
+    mSectorAllocator.seal_released_sectors();
 
     auto lockedIndex = mIndex.lock_table();
 
@@ -1030,6 +1148,7 @@ auto vfilesystem::sync_commit_info(detail::root_sector_info rootInfo,
                     ed::archive_file{"[archive-header]"});
 
     mCommittedRoot = rootInfo;
+    mSectorAllocator.discard_sealed_sectors();
 
     mWriteFlag.unmark();
     return success();
@@ -1089,6 +1208,25 @@ auto vfilesystem::list_files() -> std::vector<std::string>
     return files;
 }
 
+auto vfilesystem::cache_stats() -> vefs::cache_stats
+{
+    if (mSharedCache)
+    {
+        // the index and all vfiles use the shared cache
+        return mSharedCache->stats();
+    }
+
+    auto stats = mIndexTree->cache_stats();
+    for (auto const &[id, e] : mFiles.lock_table())
+    {
+        if (auto const file = e.instance.lock())
+        {
+            stats += file->cache_stats();
+        }
+    }
+    return stats;
+}
+
 auto vfilesystem::validate() -> result<void>
 {
     using inspection_tree
@@ -15,6 +15,7 @@
 #include "detail/archive_file_id.hpp"
 #include "detail/archive_sector_allocator.hpp"
 #include "detail/block_manager.hpp"
+#include "detail/cache_budget.hpp"
 #include "detail/cow_tree_allocator_mt.hpp"
 #include "detail/file_crypto_ctx.hpp"
 #include "detail/root_sector_info.hpp"
@@ -53,17 +54,20 @@ public:
     vfilesystem(detail::sector_device &device,
                 detail::archive_sector_allocator &allocator,
                 detail::thread_pool &executor,
-                detail::master_file_info const &info);
+                detail::master_file_info const &info,
+                archive_options const &options);
 
     static auto open_existing(detail::sector_device &device,
                               detail::archive_sector_allocator &allocator,
                               detail::thread_pool &executor,
-                              detail::master_file_info const &info)
+                              detail::master_file_info const &info,
+                              archive_options const &options = {})
             -> result<std::unique_ptr<vfilesystem>>;
     static auto create_new(detail::sector_device &device,
                            detail::archive_sector_allocator &allocator,
                            detail::thread_pool &executor,
-                           detail::master_file_info const &info)
+                           detail::master_file_info const &info,
+                           archive_options const &options = {})
             -> result<std::unique_ptr<vfilesystem>>;
 
     auto open(std::string_view const filePath, file_open_mode_bitset const mode)
@@ -97,6 +101,7 @@ public:
     auto commit() -> result<void>;
 
     auto list_files() -> std::vector<std::string>;
+    auto cache_stats() -> vefs::cache_stats;
 
     auto crypto_ctx() const noexcept -> detail::file_crypto_ctx const &
     {
@@ -112,8 +117,9 @@ public:
     auto replace_corrupted_sectors() -> result<void>;
 
 private:
-    auto open_existing_impl() -> result<void>;
-    auto create_new_impl() -> result<void>;
+    auto open_existing_impl(archive_options const &options) -> result<void>;
+    auto create_new_impl(archive_options const &options) -> result<void>;
+    auto create_shared_cache(archive_options const &options) -> result<void>;
 
     auto sync_commit_info(detail::root_sector_info rootInfo,
                           std::uint64_t maxExtent) noexcept -> result<void>;
@@ -125,6 +131,13 @@ private:
     detail::sector_device &mDevice;
     detail::archive_sector_allocator &mSectorAllocator;
     detail::thread_pool &mDeviceExecutor;
+    // shared by the sector caches of all open vfiles
+    detail::cache_budget mCacheBudget;
+    // if set, used by the index tree and all vfile trees instead of a cache
+    // per tree; needs to outlive all of them
+    std::unique_ptr<tree_type::sector_cache> mSharedCache;
+    // the eviction policy of the sector caches owned by the vfile trees
+    cache_policy mCachePolicy;
 
     detail::file_crypto_ctx mCryptoCtx;
     detail::root_sector_info mCommittedRoot;
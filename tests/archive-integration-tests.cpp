@@ -226,4 +226,69 @@ BOOST_AUTO_TEST_CASE(read_write_with_empty_prk_and_boringssl_provider)
                                   readSpan.end());
 }
 
+BOOST_AUTO_TEST_CASE(reopen_uses_the_recorded_aead)
+{
+    auto const archiveName
+            = vefs::llfio::utils::random_string(8) + ".chacha.vefs"s;
+    std::array<std::byte, 1 << 12> fileData;
+    utils::xoroshiro128plus dataGenerator{0};
+    dataGenerator.fill(fileData);
+
+    {
+        auto createrx = vefs::archive(
+                vefs_tests::current_path, archiveName, default_user_prk,
+                crypto::boringssl_chacha20_poly1305_crypto_provider(),
+                vefs::archive_handle::creation::only_if_not_exist);
+        TEST_RESULT_REQUIRE(createrx);
+        auto created = std::move(createrx).assume_value();
+
+        auto fopenrx = created.open(default_file_path,
+                                    file_open_mode::readwrite
+                                            | file_open_mode::create);
+        TEST_RESULT_REQUIRE(fopenrx);
+        auto f = std::move(fopenrx).assume_value();
+        TEST_RESULT_REQUIRE(created.write(f, fileData, 0));
+        TEST_RESULT_REQUIRE(created.commit(f));
+        f = nullptr;
+        TEST_RESULT_REQUIRE(created.commit());
+    }
+
+    // any builtin provider can open the archive
+    auto openrx
+            = vefs::archive(vefs_tests::current_path, archiveName,
+                            default_user_prk,
+                            crypto::boringssl_aes_256_gcm_crypto_provider());
+    TEST_RESULT_REQUIRE(openrx);
+    auto opened = std::move(openrx).assume_value();
+
+    auto fopenrx = opened.open(default_file_path, file_open_mode::read);
+    TEST_RESULT_REQUIRE(fopenrx);
+    auto f = std::move(fopenrx).assume_value();
+
+    std::array<std::byte, 1 << 12> readBuffer;
+    TEST_RESULT_REQUIRE(opened.read(f, readBuffer, 0));
+    BOOST_TEST(readBuffer == fileData, boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(reopen_assumes_the_default_aead_if_none_is_recorded)
+{
+    auto const archiveName
+            = vefs::llfio::utils::random_string(8) + ".gcm.vefs"s;
+    {
+        // AES-256-GCM archives keep the static header layout which predates
+        // the aead record
+        auto createrx = vefs::archive(
+                vefs_tests::current_path, archiveName, default_user_prk,
+                crypto::boringssl_aes_256_gcm_crypto_provider(),
+                vefs::archive_handle::creation::only_if_not_exist);
+        TEST_RESULT_REQUIRE(createrx);
+        TEST_RESULT_REQUIRE(createrx.assume_value().commit());
+    }
+
+    auto openrx = vefs::archive(
+            vefs_tests::current_path, archiveName, default_user_prk,
+            crypto::boringssl_chacha20_poly1305_crypto_provider());
+    TEST_RESULT(openrx);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
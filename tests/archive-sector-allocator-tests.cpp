@@ -1,6 +1,9 @@
 #include "boost-unit-test.hpp"
 #include "vefs/detail/archive_sector_allocator.hpp"
 
+#include <algorithm>
+#include <array>
+
 #include <vefs/detail/preallocated_tree_allocator.hpp>
 #include <vefs/detail/sector_tree_seq.hpp>
 #include <vefs/utils/binary_codec.hpp>
@@ -63,6 +66,78 @@ BOOST_AUTO_TEST_CASE(dealloc_one)
     TEST_RESULT_REQUIRE(deallocrx);
 }
 
+BOOST_AUTO_TEST_CASE(dealloc_many_discards_the_sectors_after_the_header_update)
+{
+    device->discard_free_sectors(true);
+
+    std::array<sector_id, 3> sectors{};
+    for (auto &sector : sectors)
+    {
+        auto allocrx = testSubject.alloc_one();
+        TEST_RESULT_REQUIRE(allocrx);
+        sector = allocrx.assume_value();
+    }
+
+    std::array<std::byte, 16> mac{};
+    std::array<std::byte, sector_device::sector_payload_size> content{};
+    std::ranges::fill(content, std::byte{0x1a});
+    TEST_RESULT_REQUIRE(device->write_sector(
+            mac, fileCryptoContext, sectors[1], content));
+
+    std::ranges::reverse(sectors);
+    testSubject.dealloc_many(sectors,
+                             archive_sector_allocator::leak_on_failure);
+    BOOST_TEST(!testSubject.sector_leak_detected());
+    BOOST_TEST(std::ranges::is_sorted(sectors));
+
+    // the header on disk may still reference the sectors
+    testSubject.seal_released_sectors();
+    TEST_RESULT(device->read_sector(content, fileCryptoContext, sectors[1],
+                                    mac));
+    auto const reallocrx = testSubject.alloc_one();
+    TEST_RESULT_REQUIRE(reallocrx);
+    BOOST_TEST(std::ranges::find(sectors, reallocrx.assume_value())
+               == sectors.end());
+
+    // the discarded sector reads as zeros, i.e. it can't be authenticated
+    testSubject.discard_sealed_sectors();
+    auto readrx = device->read_sector(content, fileCryptoContext, sectors[1],
+                                      mac);
+    BOOST_TEST(readrx.has_failure());
+
+    auto allocrx = testSubject.alloc_one();
+    TEST_RESULT_REQUIRE(allocrx);
+    BOOST_TEST(std::ranges::find(sectors, allocrx.assume_value())
+               != sectors.end());
+}
+
+BOOST_AUTO_TEST_CASE(sectors_released_after_sealing_wait_for_the_next_header)
+{
+    device->discard_free_sectors(true);
+
+    auto allocrx = testSubject.alloc_one();
+    TEST_RESULT_REQUIRE(allocrx);
+    std::array<sector_id, 1> sectors{allocrx.assume_value()};
+
+    std::array<std::byte, 16> mac{};
+    std::array<std::byte, sector_device::sector_payload_size> content{};
+    TEST_RESULT_REQUIRE(device->write_sector(
+            mac, fileCryptoContext, sectors[0], content));
+
+    testSubject.seal_released_sectors();
+    testSubject.dealloc_many(sectors,
+                             archive_sector_allocator::leak_on_failure);
+    testSubject.discard_sealed_sectors();
+    TEST_RESULT(device->read_sector(content, fileCryptoContext, sectors[0],
+                                    mac));
+
+    testSubject.seal_released_sectors();
+    testSubject.discard_sealed_sectors();
+    auto readrx = device->read_sector(content, fileCryptoContext, sectors[0],
+                                      mac);
+    BOOST_TEST(readrx.has_failure());
+}
+
 BOOST_FIXTURE_TEST_CASE(shrink_large_free_sector_file,
                         archive_sector_allocator_dependencies)
 {
@@ -1,3 +1,5 @@
+#include <vector>
+
 #include <vefs/archive.hpp>
 #include <vefs/platform/thread_pool.hpp>
 #include <vefs/utils/random.hpp>
@@ -166,6 +168,28 @@ BOOST_AUTO_TEST_CASE(create_a_new_file_succeeds)
     TEST_RESULT_REQUIRE(reopenedFile);
 }
 
+BOOST_AUTO_TEST_CASE(many_files_can_be_opened_with_default_options)
+{
+    // more files than the default budget could grant 32 MiB caches
+    constexpr std::size_t numFiles = 40U;
+
+    std::vector<vfile_handle> files;
+    files.reserve(numFiles);
+    for (std::size_t i = 0U; i < numFiles; ++i)
+    {
+        auto fileRx = testSubject.open(
+                "file-" + std::to_string(i),
+                file_open_mode::readwrite | file_open_mode::create);
+        TEST_RESULT_REQUIRE(fileRx);
+        files.push_back(std::move(fileRx).assume_value());
+    }
+    for (auto const &file : files)
+    {
+        TEST_RESULT_REQUIRE(testSubject.commit(file));
+    }
+    TEST_RESULT(testSubject.commit());
+}
+
 BOOST_AUTO_TEST_CASE(read_content_that_was_written)
 {
     constexpr std::uint64_t pos
@@ -200,6 +224,77 @@ BOOST_AUTO_TEST_CASE(read_content_that_was_written)
                                   readSpan.begin(), readSpan.end());
 }
 
+BOOST_FIXTURE_TEST_CASE(files_share_archive_sector_cache, basic_dependencies)
+{
+    archive_options const options{
+            .cache_budget = std::size_t{8} << 20,
+            .shared_sector_cache = true,
+    };
+    auto tempINode = llfio::temp_inode().value();
+    auto openrx = vefs::archive(
+            tempINode, default_user_prk, cprov,
+            vefs::archive_handle::creation::only_if_not_exist, options);
+    TEST_RESULT_REQUIRE(openrx);
+    auto subject = std::move(openrx).assume_value();
+
+    using file_type = std::array<std::byte, (1 << 17) * 3 - 1>;
+    auto content = std::make_unique<file_type>();
+    utils::xoroshiro128plus dataGenerator{0xC0DE'DEAD'BEEF'3ABA};
+    dataGenerator.fill(std::span{*content});
+
+    constexpr std::array filePaths{"first"sv, "second"sv};
+    for (auto const filePath : filePaths)
+    {
+        auto fileRx = subject.open(filePath, file_open_mode::readwrite
+                                                     | file_open_mode::create);
+        TEST_RESULT_REQUIRE(fileRx);
+        TEST_RESULT(subject.write(fileRx.assume_value(), std::span{*content},
+                                  0U));
+        TEST_RESULT_REQUIRE(subject.commit(fileRx.assume_value()));
+    }
+    TEST_RESULT_REQUIRE(subject.commit());
+    subject = {};
+
+    openrx = vefs::archive(tempINode, default_user_prk, cprov,
+                           vefs::archive_handle::creation::open_existing,
+                           options);
+    TEST_RESULT_REQUIRE(openrx);
+    subject = std::move(openrx).assume_value();
+
+    auto readBuffer = std::make_unique<file_type>();
+    for (auto const filePath : filePaths)
+    {
+        auto fileRx = subject.open(filePath, file_open_mode::read);
+        TEST_RESULT_REQUIRE(fileRx);
+        TEST_RESULT(subject.read(fileRx.assume_value(),
+                                 std::span{*readBuffer}, 0U));
+        BOOST_TEST((*readBuffer == *content));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(cache_stats_include_open_files)
+{
+    using file_type = std::array<std::byte, (1 << 17) * 3 - 1>;
+    auto content = std::make_unique<file_type>();
+    utils::xoroshiro128plus dataGenerator{0};
+    dataGenerator.fill(std::span{*content});
+
+    auto const statsBefore = testSubject.cache_stats();
+
+    auto fileRx = testSubject.open(default_file_path,
+                                   file_open_mode::readwrite
+                                           | file_open_mode::create);
+    TEST_RESULT_REQUIRE(fileRx);
+    TEST_RESULT_REQUIRE(testSubject.write(fileRx.assume_value(),
+                                          std::span{*content}, 0U));
+    auto const statsAfterWrite = testSubject.cache_stats();
+    BOOST_TEST(statsAfterWrite.misses > statsBefore.misses);
+
+    TEST_RESULT_REQUIRE(testSubject.read(fileRx.assume_value(),
+                                         std::span{*content}, 0U));
+    BOOST_TEST(testSubject.cache_stats().hits > statsAfterWrite.hits);
+}
+
 BOOST_AUTO_TEST_CASE(archive_file_shrink)
 {
     constexpr std::uint64_t pos
@@ -0,0 +1,80 @@
+#include "vefs/detail/cache_budget.hpp"
+
+#include <thread>
+
+#include "boost-unit-test.hpp"
+#include "test-utils.hpp"
+
+using namespace vefs::detail;
+
+namespace vefs_tests
+{
+
+BOOST_AUTO_TEST_SUITE(cache_budget_tests)
+
+constexpr std::size_t page_size = 1U << 15;
+
+auto minimum_pages() -> std::size_t
+{
+    return cache_budget::min_cache_pages
+           + std::thread::hardware_concurrency() * 2U;
+}
+
+BOOST_AUTO_TEST_CASE(small_files_get_the_minimum)
+{
+    cache_budget subject(std::size_t{1} << 30, 0U, page_size);
+
+    auto const granted = subject.acquire(1U);
+    BOOST_TEST(granted == minimum_pages());
+
+    subject.release(granted);
+    BOOST_TEST(subject.available()
+               == static_cast<std::ptrdiff_t>((std::size_t{1} << 30)
+                                              / page_size));
+}
+
+BOOST_AUTO_TEST_CASE(large_files_are_limited_by_the_budget)
+{
+    cache_budget subject(std::size_t{1} << 30, 0U, page_size);
+
+    auto const granted = subject.acquire(std::uint64_t{1} << 40);
+    BOOST_TEST(granted == (std::size_t{1} << 30) / page_size);
+    BOOST_TEST(subject.available() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(exhausted_budget_grants_nothing)
+{
+    auto const minimumSize = (minimum_pages() + 16U) * page_size;
+    cache_budget subject(minimumSize + 16U * page_size, minimumSize,
+                         page_size);
+
+    auto const first = subject.acquire(1U);
+    auto const second = subject.acquire(1U);
+    BOOST_TEST(first == minimum_pages() + 16U);
+    BOOST_TEST(second == 0U);
+    BOOST_TEST(subject.available() == 16);
+
+    subject.release(first);
+    BOOST_TEST(subject.available()
+               == static_cast<std::ptrdiff_t>(minimum_pages() + 32U));
+}
+
+BOOST_AUTO_TEST_CASE(exhausted_soft_budget_grants_the_minimum)
+{
+    cache_budget subject(16U * page_size, 0U, page_size, false);
+
+    auto const first = subject.acquire(std::uint64_t{1} << 40);
+    auto const second = subject.acquire(1U);
+    BOOST_TEST(first == minimum_pages());
+    BOOST_TEST(second == minimum_pages());
+    BOOST_TEST(subject.available()
+               == 16 - 2 * static_cast<std::ptrdiff_t>(minimum_pages()));
+
+    subject.release(first);
+    subject.release(second);
+    BOOST_TEST(subject.available() == 16);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace vefs_tests
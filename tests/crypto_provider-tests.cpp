@@ -85,6 +85,143 @@ BOOST_AUTO_TEST_CASE(boringssl_decrypts_returns_error_if_mac_is_18_bytes_long)
     BOOST_TEST(open_result.error().value() == 5);
 }
 
+BOOST_AUTO_TEST_CASE(boringssl_batch_seal_matches_single_seal_and_opens)
+{
+    constexpr std::size_t numBoxes = 3U;
+    std::array<std::array<std::byte, 44>, numBoxes> keys;
+    std::array<std::array<std::byte, 16>, numBoxes> macs;
+    std::array<std::array<std::byte, 64>, numBoxes> ciphertexts;
+    std::array<std::byte, 64> msg;
+    vefs::fill_blob(std::span(msg), std::byte{0xaa});
+
+    std::array<vefs::crypto::seal_box, numBoxes> sealBoxes;
+    for (std::size_t i = 0U; i < numBoxes; ++i)
+    {
+        vefs::fill_blob(std::span(keys[i]), static_cast<std::byte>(i));
+        sealBoxes[i] = {std::span(ciphertexts[i]), std::span(macs[i]),
+                        std::span(keys[i]), std::span(msg)};
+    }
+    std::size_t failedBox = numBoxes;
+    TEST_RESULT_REQUIRE(test_subject->box_seal_batch(sealBoxes, failedBox));
+
+    std::array<std::byte, 16> singleMac;
+    std::array<std::byte, 64> singleCiphertext;
+    TEST_RESULT_REQUIRE(test_subject->box_seal(std::span(singleCiphertext),
+                                               std::span(singleMac),
+                                               std::span(keys[1]),
+                                               std::span(msg)));
+    BOOST_TEST(singleCiphertext == ciphertexts[1],
+               boost::test_tools::per_element{});
+    BOOST_TEST(singleMac == macs[1], boost::test_tools::per_element{});
+
+    std::array<std::array<std::byte, 64>, numBoxes> plaintexts;
+    std::array<vefs::crypto::open_box, numBoxes> openBoxes;
+    for (std::size_t i = 0U; i < numBoxes; ++i)
+    {
+        openBoxes[i] = {std::span(plaintexts[i]), std::span(keys[i]),
+                        std::span(ciphertexts[i]), std::span(macs[i])};
+    }
+    TEST_RESULT_REQUIRE(test_subject->box_open_batch(openBoxes, failedBox));
+    for (auto const &plaintext : plaintexts)
+    {
+        BOOST_TEST(plaintext == msg, boost::test_tools::per_element{});
+    }
+}
+
+BOOST_AUTO_TEST_CASE(boringssl_batch_open_reports_the_tampered_box)
+{
+    constexpr std::size_t numBoxes = 3U;
+    std::array<std::byte, 44> key;
+    std::array<std::byte, 64> msg;
+    std::array<std::array<std::byte, 16>, numBoxes> macs;
+    std::array<std::array<std::byte, 64>, numBoxes> ciphertexts;
+    std::array<std::array<std::byte, 64>, numBoxes> plaintexts;
+    vefs::fill_blob(std::span(key), std::byte{0xbb});
+    vefs::fill_blob(std::span(msg), std::byte{0xaa});
+
+    std::array<vefs::crypto::open_box, numBoxes> boxes;
+    for (std::size_t i = 0U; i < numBoxes; ++i)
+    {
+        TEST_RESULT_REQUIRE(test_subject->box_seal(
+                std::span(ciphertexts[i]), std::span(macs[i]), std::span(key),
+                std::span(msg)));
+        boxes[i] = {std::span(plaintexts[i]), std::span(key),
+                    std::span(ciphertexts[i]), std::span(macs[i])};
+    }
+    ciphertexts[1][7] ^= std::byte{0x01};
+
+    std::size_t failedBox = numBoxes;
+    auto const openRx = test_subject->box_open_batch(boxes, failedBox);
+    BOOST_TEST_REQUIRE(openRx.has_error());
+    BOOST_TEST(openRx.assume_error() == vefs::archive_errc::tag_mismatch);
+    BOOST_TEST(failedBox == 1U);
+    // the preceding boxes have been opened
+    BOOST_TEST(plaintexts[0] == msg, boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(alternative_aeads_round_trip_with_distinct_ciphertexts)
+{
+    std::array<std::byte, 44> key;
+    std::array<std::byte, 64> msg;
+    vefs::fill_blob(std::span(key), std::byte{0xbb});
+    vefs::fill_blob(std::span(msg), std::byte{0xaa});
+
+    std::array<std::byte, 16> gcmMac;
+    std::array<std::byte, 64> gcmCiphertext;
+    TEST_RESULT_REQUIRE(test_subject->box_seal(std::span(gcmCiphertext),
+                                               std::span(gcmMac),
+                                               std::span(key), std::span(msg)));
+
+    vefs::crypto::crypto_provider *const alternatives[] = {
+            vefs::crypto::boringssl_chacha20_poly1305_crypto_provider(),
+            vefs::crypto::boringssl_aes_256_gcm_siv_crypto_provider(),
+    };
+    for (auto *const provider : alternatives)
+    {
+        std::array<std::byte, 16> mac;
+        std::array<std::byte, 64> ciphertext;
+        std::array<std::byte, 64> plaintext;
+        TEST_RESULT_REQUIRE(provider->box_seal(std::span(ciphertext),
+                                               std::span(mac), std::span(key),
+                                               std::span(msg)));
+        BOOST_TEST((ciphertext != gcmCiphertext));
+
+        TEST_RESULT_REQUIRE(provider->box_open(std::span(plaintext),
+                                               std::span(key),
+                                               std::span(ciphertext),
+                                               std::span(mac)));
+        BOOST_TEST(plaintext == msg, boost::test_tools::per_element{});
+
+        // a box can't be opened with another algorithm
+        BOOST_TEST(test_subject
+                           ->box_open(std::span(plaintext), std::span(key),
+                                      std::span(ciphertext), std::span(mac))
+                           .has_error());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(builtin_providers_are_looked_up_by_their_algorithm)
+{
+    using vefs::crypto::aead_algorithm;
+    for (auto const algorithm :
+         {aead_algorithm::aes_256_gcm, aead_algorithm::chacha20_poly1305,
+          aead_algorithm::aes_256_gcm_siv})
+    {
+        auto *const provider
+                = vefs::crypto::boringssl_crypto_provider(algorithm);
+        BOOST_TEST_REQUIRE(provider != nullptr);
+        BOOST_TEST((provider->algorithm == algorithm));
+    }
+    BOOST_TEST(vefs::crypto::boringssl_crypto_provider(
+                       aead_algorithm::unspecified)
+               == nullptr);
+
+    auto const preferred
+            = vefs::crypto::boringssl_preferred_crypto_provider()->algorithm;
+    BOOST_TEST((preferred == aead_algorithm::aes_256_gcm
+                || preferred == aead_algorithm::chacha20_poly1305));
+}
+
 BOOST_AUTO_TEST_CASE(ct_compare_compares_two_equal_spans_return_true)
 {
     std::array<std::byte, 5> key;
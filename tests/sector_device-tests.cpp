@@ -3,6 +3,10 @@
 #include "mocks.hpp"
 #include "test-utils.hpp"
 
+#include <algorithm>
+#include <vector>
+
+#include <vefs/archive_fwd.hpp>
 #include <vefs/span.hpp>
 #include <vefs/utils/secure_array.hpp>
 
@@ -39,6 +43,26 @@ struct sector_device_test_fixture
     }
 };
 
+namespace
+{
+
+auto io_uring_is_available(boost::unit_test::test_unit_id)
+        -> boost::test_tools::assertion_result
+{
+    std::array<std::byte, 32> const userPRK{};
+    auto probeFile = vefs::llfio::temp_inode().value();
+    auto const probeRx = vefs::detail::sector_device::create_new(
+            probeFile.reopen().value(),
+            vefs::crypto::boringssl_aes_256_gcm_crypto_provider(), userPRK,
+            vefs::io_engine::io_uring);
+
+    boost::test_tools::assertion_result available(probeRx.has_value());
+    available.message() << "io_uring is unavailable on this host";
+    return available;
+}
+
+} // namespace
+
 BOOST_FIXTURE_TEST_SUITE(sector_device_tests, sector_device_test_fixture)
 
 BOOST_AUTO_TEST_CASE(
@@ -58,6 +82,44 @@ BOOST_AUTO_TEST_CASE(open_existing_sector_device_throws_error_for_empty_file)
                == vefs::archive_errc::no_archive_header);
 }
 
+BOOST_AUTO_TEST_CASE(open_existing_fails_if_both_archive_headers_are_empty)
+{
+    using vefs::detail::sector_device;
+    auto archiveFile = vefs::llfio::temp_inode().value();
+    TEST_RESULT_REQUIRE(sector_device::create_new(
+            archiveFile.reopen().value(),
+            vefs::crypto::boringssl_aes_256_gcm_crypto_provider(),
+            default_user_prk));
+
+    // a well formed box head which announces an empty ciphertext:
+    // [bstr(32) salt, bstr(16) mac, bstr(0)]
+    std::array<std::byte, 53> emptyBox{};
+    emptyBox[0] = std::byte{0x83};
+    emptyBox[1] = std::byte{0x58};
+    emptyBox[2] = std::byte{0x20};
+    emptyBox[35] = std::byte{0x50};
+    emptyBox[52] = std::byte{0x40};
+    vefs::llfio::file_handle::const_buffer_type buffers[] = {
+            {emptyBox.data(), emptyBox.size()}
+    };
+    auto const firstHeaderOffset = sector_device::static_header_size
+                                   + sector_device::personalization_area_size;
+    for (auto const offset :
+         {firstHeaderOffset, firstHeaderOffset + sector_device::pheader_size})
+    {
+        TEST_RESULT_REQUIRE(archiveFile.write({buffers, offset}));
+    }
+
+    auto deviceRx = sector_device::open_existing(
+            archiveFile.reopen().value(),
+            vefs::crypto::boringssl_aes_256_gcm_crypto_provider(),
+            default_user_prk);
+
+    BOOST_TEST_REQUIRE(deviceRx.has_error());
+    BOOST_TEST(deviceRx.assume_error()
+               == vefs::archive_errc::no_archive_header);
+}
+
 // the currently used gtest version cannot match a std::span
 // BOOST_AUTO_TEST_CASE(write_sector_seals_sector)
 //{
@@ -177,4 +239,259 @@ BOOST_AUTO_TEST_CASE(read_sector_does_not_work_for_master_sector)
     BOOST_TEST(result.assume_error() == vefs::errc::invalid_argument);
 }
 
+BOOST_AUTO_TEST_CASE(
+        write_sectors_rejects_batches_containing_the_master_sector)
+{
+    std::byte mac_data[2][16];
+    std::byte ro_data[32'736];
+    auto fileCryptoCtx = vefs::detail::file_crypto_ctx(
+            vefs::detail::file_crypto_ctx::zero_init_t{});
+    using write_request = vefs::detail::sector_device::write_request<>;
+    write_request const requests[] = {
+            {vefs::rw_blob<16>(mac_data[0]), &fileCryptoCtx,
+             vefs::detail::sector_id{1}, vefs::ro_blob<32'736>(ro_data)},
+            {vefs::rw_blob<16>(mac_data[1]), &fileCryptoCtx,
+             vefs::detail::sector_id::master, vefs::ro_blob<32'736>(ro_data)},
+    };
+
+    auto result = testSubject->write_sectors(
+            std::span<write_request const>(requests));
+
+    BOOST_TEST(result.has_error());
+    BOOST_TEST(result.assume_error() == vefs::errc::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(read_sectors_returns_sectors_written_by_write_sectors)
+{
+    // the mock doesn't encrypt anything, i.e. a real provider is required in
+    // order to verify that the batches are sealed and opened correctly
+    auto cryptoFile = vefs::llfio::temp_inode().value();
+    auto device = vefs::detail::sector_device::create_new(
+                          cryptoFile.reopen().value(),
+                          vefs::crypto::boringssl_aes_256_gcm_crypto_provider(),
+                          default_user_prk)
+                          .value()
+                          .device;
+    TEST_RESULT_REQUIRE(device->resize(5U));
+
+    constexpr std::size_t numSectors = 3U;
+    std::byte mac_data[numSectors][16];
+    std::byte ro_data[numSectors][32'736];
+    std::byte rw_data[numSectors][32'736];
+    auto fileCryptoCtx = vefs::detail::file_crypto_ctx(
+            vefs::detail::file_crypto_ctx::zero_init_t{});
+
+    // sectors 1 & 2 are coalesced while sector 4 needs a separate write
+    vefs::detail::sector_id const sectors[numSectors]
+            = {vefs::detail::sector_id{1}, vefs::detail::sector_id{2},
+               vefs::detail::sector_id{4}};
+
+    using write_request = vefs::detail::sector_device::write_request<>;
+    using read_request = vefs::detail::sector_device::read_request;
+    std::vector<write_request> writeRequests;
+    std::vector<read_request> readRequests;
+    for (std::size_t i = 0U; i < numSectors; ++i)
+    {
+        vefs::fill_blob(vefs::rw_blob<32'736>(ro_data[i]),
+                        static_cast<std::byte>(0x1a + i));
+        vefs::fill_blob(vefs::rw_blob<32'736>(rw_data[i]), std::byte{});
+        writeRequests.push_back({vefs::rw_blob<16>(mac_data[i]),
+                                 &fileCryptoCtx, sectors[i],
+                                 vefs::ro_blob<32'736>(ro_data[i])});
+        readRequests.push_back({vefs::rw_blob<32'736>(rw_data[i]),
+                                &fileCryptoCtx, sectors[i],
+                                vefs::ro_blob<16>(mac_data[i])});
+    }
+
+    TEST_RESULT_REQUIRE(device->write_sectors(
+            std::span<write_request const>(writeRequests)));
+    TEST_RESULT_REQUIRE(device->read_sectors(readRequests));
+
+    for (std::size_t i = 0U; i < numSectors; ++i)
+    {
+        BOOST_TEST(std::ranges::equal(rw_data[i], ro_data[i]));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(read_sector_decrypts_in_place)
+{
+    std::byte mac_data[16];
+    std::byte ro_data[32'736];
+    std::byte rw_data[32'736];
+    vefs::fill_blob(vefs::rw_blob<32'736>(ro_data), std::byte(0x1a));
+    auto fileCryptoCtx = vefs::detail::file_crypto_ctx(
+            vefs::detail::file_crypto_ctx::zero_init_t{});
+
+    EXPECT_CALL(cryptoProviderMock,
+                box_open(testing::_, testing::_, testing::_, testing::_))
+            .WillOnce([&](vefs::rw_dynblob plaintext, vefs::ro_dynblob,
+                          vefs::ro_dynblob ciphertext,
+                          vefs::ro_dynblob) -> vefs::result<void> {
+                BOOST_TEST(plaintext.data() == std::data(rw_data));
+                BOOST_TEST(ciphertext.data() == plaintext.data());
+                BOOST_TEST(ciphertext.size() == plaintext.size());
+                return vefs::outcome::success();
+            });
+    TEST_RESULT_REQUIRE(testSubject->resize(2U));
+
+    TEST_RESULT_REQUIRE(testSubject->write_sector(
+            vefs::rw_blob<16>(mac_data), fileCryptoCtx,
+            vefs::detail::sector_id{1}, vefs::ro_blob<32'736>(ro_data)));
+    TEST_RESULT_REQUIRE(testSubject->read_sector(
+            vefs::rw_blob<32'736>(rw_data), fileCryptoCtx,
+            vefs::detail::sector_id{1}, vefs::ro_blob<16>(mac_data)));
+}
+
+BOOST_AUTO_TEST_CASE(erase_sectors_destroys_the_sector_salts)
+{
+    TEST_RESULT_REQUIRE(testSubject->resize(12U));
+
+    std::byte mac_data[16];
+    std::byte ro_data[32'736];
+    vefs::fill_blob(vefs::rw_blob<32'736>(ro_data), std::byte(0x1a));
+    auto fileCryptoCtx = vefs::detail::file_crypto_ctx(
+            vefs::detail::file_crypto_ctx::zero_init_t{});
+
+    // more sectors than fit into a single keystream batch
+    std::vector<vefs::detail::sector_id> sectors;
+    for (std::uint64_t i = 1U; i < 12U; ++i)
+    {
+        sectors.push_back(vefs::detail::sector_id{i});
+        TEST_RESULT_REQUIRE(testSubject->write_sector(
+                vefs::rw_blob<16>(mac_data), fileCryptoCtx, sectors.back(),
+                vefs::ro_blob<32'736>(ro_data)));
+    }
+
+    // the first sector of both keystream batches
+    vefs::detail::sector_id const probes[] = {sectors[0], sectors[8]};
+    auto const readSalt = [&](vefs::detail::sector_id which) {
+        std::array<std::byte, 32> salt{};
+        vefs::llfio::file_handle::buffer_type buffers[] = {
+                {salt.data(), salt.size()}
+        };
+        (void)testFile.read(
+                {buffers, vefs::detail::sector_device::to_offset(which)})
+                .value();
+        return salt;
+    };
+    std::array<std::byte, 32> const sealedSalts[]
+            = {readSalt(probes[0]), readSalt(probes[1])};
+
+    TEST_RESULT_REQUIRE(testSubject->erase_sectors(sectors));
+
+    std::array<std::byte, 32> const erasedSalts[]
+            = {readSalt(probes[0]), readSalt(probes[1])};
+    BOOST_TEST((erasedSalts[0] != sealedSalts[0]));
+    BOOST_TEST((erasedSalts[1] != sealedSalts[1]));
+    // every batch consumes a different keystream
+    BOOST_TEST((erasedSalts[0] != erasedSalts[1]));
+}
+
+BOOST_AUTO_TEST_CASE(discarding_erase_zeroes_whole_sectors)
+{
+    TEST_RESULT_REQUIRE(testSubject->resize(4U));
+    testSubject->discard_free_sectors(true);
+
+    std::byte mac_data[16];
+    std::byte ro_data[32'736];
+    vefs::fill_blob(vefs::rw_blob<32'736>(ro_data), std::byte(0x1a));
+    auto fileCryptoCtx = vefs::detail::file_crypto_ctx(
+            vefs::detail::file_crypto_ctx::zero_init_t{});
+
+    vefs::detail::sector_id const sectors[] = {vefs::detail::sector_id{1},
+                                               vefs::detail::sector_id{2}};
+    for (auto const sector : sectors)
+    {
+        TEST_RESULT_REQUIRE(testSubject->write_sector(
+                vefs::rw_blob<16>(mac_data), fileCryptoCtx, sector,
+                vefs::ro_blob<32'736>(ro_data)));
+    }
+
+    TEST_RESULT_REQUIRE(testSubject->erase_sectors(sectors));
+
+    std::vector<std::byte> content(2 * vefs::detail::sector_device::sector_size,
+                                   std::byte{0xff});
+    vefs::llfio::file_handle::buffer_type buffers[] = {
+            {content.data(), content.size()}
+    };
+    (void)testFile
+            .read({buffers, vefs::detail::sector_device::to_offset(sectors[0])})
+            .value();
+    BOOST_TEST(std::all_of(content.begin(), content.end(),
+                           [](std::byte v) { return v == std::byte{}; }));
+    // discarding keeps the file size
+    BOOST_TEST(testSubject->size() == 4U);
+}
+
+BOOST_AUTO_TEST_CASE(read_sectors_fails_past_the_end_of_file)
+{
+    std::byte mac_data[16]{};
+    std::byte rw_data[32'736];
+    auto fileCryptoCtx = vefs::detail::file_crypto_ctx(
+            vefs::detail::file_crypto_ctx::zero_init_t{});
+
+    using read_request = vefs::detail::sector_device::read_request;
+    read_request const readRequests[] = {
+            {vefs::rw_blob<32'736>(rw_data), &fileCryptoCtx,
+             vefs::detail::sector_id{4}, vefs::ro_blob<16>(mac_data)},
+    };
+
+    auto const readRx = testSubject->read_sectors(readRequests);
+    BOOST_TEST_REQUIRE(readRx.has_error());
+    BOOST_TEST(readRx.assume_error()
+               == vefs::archive_errc::sector_reference_out_of_range);
+}
+
+BOOST_AUTO_TEST_CASE(io_uring_engine_reads_sectors_written_by_write_sectors,
+                     *boost::unit_test::precondition(io_uring_is_available))
+{
+    auto uringFile = vefs::llfio::temp_inode().value();
+    auto device = vefs::detail::sector_device::create_new(
+                          uringFile.reopen().value(),
+                          vefs::crypto::boringssl_aes_256_gcm_crypto_provider(),
+                          default_user_prk, vefs::io_engine::io_uring)
+                          .value()
+                          .device;
+    TEST_RESULT_REQUIRE(device->resize(3U));
+
+    std::byte mac_data[3][16]{};
+    std::byte ro_data[2][32'736];
+    std::byte rw_data[3][32'736]{};
+    vefs::fill_blob(vefs::rw_blob<32'736>(ro_data[0]), std::byte(0x1a));
+    vefs::fill_blob(vefs::rw_blob<32'736>(ro_data[1]), std::byte(0x1b));
+    auto fileCryptoCtx = vefs::detail::file_crypto_ctx(
+            vefs::detail::file_crypto_ctx::zero_init_t{});
+
+    using write_request = vefs::detail::sector_device::write_request<>;
+    using read_request = vefs::detail::sector_device::read_request;
+    write_request const writeRequests[] = {
+            {vefs::rw_blob<16>(mac_data[0]), &fileCryptoCtx,
+             vefs::detail::sector_id{1}, vefs::ro_blob<32'736>(ro_data[0])},
+            {vefs::rw_blob<16>(mac_data[1]), &fileCryptoCtx,
+             vefs::detail::sector_id{2}, vefs::ro_blob<32'736>(ro_data[1])},
+    };
+    read_request const readRequests[] = {
+            {vefs::rw_blob<32'736>(rw_data[0]), &fileCryptoCtx,
+             vefs::detail::sector_id{1}, vefs::ro_blob<16>(mac_data[0])},
+            {vefs::rw_blob<32'736>(rw_data[1]), &fileCryptoCtx,
+             vefs::detail::sector_id{2}, vefs::ro_blob<16>(mac_data[1])},
+    };
+
+    TEST_RESULT_REQUIRE(device->write_sectors(
+            std::span<write_request const>(writeRequests)));
+    TEST_RESULT_REQUIRE(device->read_sectors(readRequests));
+    BOOST_TEST(std::ranges::equal(rw_data[0], ro_data[0]));
+    BOOST_TEST(std::ranges::equal(rw_data[1], ro_data[1]));
+
+    // the end of file is reported like by the synchronous engine
+    read_request const pastEndRequests[] = {
+            {vefs::rw_blob<32'736>(rw_data[2]), &fileCryptoCtx,
+             vefs::detail::sector_id{4}, vefs::ro_blob<16>(mac_data[2])},
+    };
+    auto const pastEndRx = device->read_sectors(pastEndRequests);
+    BOOST_TEST_REQUIRE(pastEndRx.has_error());
+    BOOST_TEST(pastEndRx.assume_error()
+               == vefs::archive_errc::sector_reference_out_of_range);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
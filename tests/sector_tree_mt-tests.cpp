@@ -1,6 +1,11 @@
 #include "vefs/detail/sector_tree_mt.hpp"
 #include "boost-unit-test.hpp"
 
+#include <algorithm>
+#include <memory>
+#include <span>
+#include <vector>
+
 #include <dplx/cncr/misc.hpp>
 
 #include <vefs/platform/thread_pool.hpp>
@@ -86,6 +91,34 @@ public:
     }
 };
 
+//! queues the tasks until run_all() is called
+class deferred_executor final : public thread_pool
+{
+public:
+    deferred_executor() noexcept = default;
+
+    auto num_queued() const noexcept -> std::size_t
+    {
+        return mTasks.size();
+    }
+    void run_all() noexcept
+    {
+        for (auto &task : mTasks)
+        {
+            xdo(*task);
+        }
+        mTasks.clear();
+    }
+
+private:
+    void execute(std::unique_ptr<task_t> task) override
+    {
+        mTasks.push_back(std::move(task));
+    }
+
+    std::vector<std::unique_ptr<task_t>> mTasks;
+};
+
 } // namespace
 
 template class vefs::detail::sector_tree_mt<allocator_stub>;
@@ -126,9 +159,11 @@ struct sector_tree_mt_fixture : sector_tree_mt_dependencies
         : sector_tree_mt_dependencies()
         , existingTree()
     {
-        existingTree
-                = tree_type::create_new(*device, fileCryptoContext, *device)
-                          .value();
+        existingTree = tree_type::create_new(*device, fileCryptoContext,
+                                             tree_type::default_cache_size,
+                                             cache_policy::least_recently_used,
+                                             *device)
+                               .value();
 
         existingTree
                 ->commit([this](root_sector_info ri) { rootSectorInfo = ri; })
@@ -140,7 +175,10 @@ BOOST_FIXTURE_TEST_SUITE(sector_tree_mt_tests, sector_tree_mt_fixture)
 
 BOOST_FIXTURE_TEST_CASE(new_sector_tree_has_id_one, sector_tree_mt_dependencies)
 {
-    auto createrx = tree_type::create_new(*device, fileCryptoContext, *device);
+    auto createrx = tree_type::create_new(*device, fileCryptoContext,
+                                          tree_type::default_cache_size,
+                                          cache_policy::least_recently_used,
+                                          *device);
     TEST_RESULT_REQUIRE(createrx);
     auto newTree = std::move(createrx).assume_value();
     root_sector_info newRootInfo;
@@ -154,7 +192,10 @@ BOOST_FIXTURE_TEST_CASE(new_sector_tree_has_id_one, sector_tree_mt_dependencies)
 BOOST_FIXTURE_TEST_CASE(check_initial_sector_tree_mac,
                         sector_tree_mt_dependencies)
 {
-    auto createrx = tree_type::create_new(*device, fileCryptoContext, *device);
+    auto createrx = tree_type::create_new(*device, fileCryptoContext,
+                                          tree_type::default_cache_size,
+                                          cache_policy::least_recently_used,
+                                          *device);
     TEST_RESULT_REQUIRE(createrx);
     auto newTree = std::move(createrx).assume_value();
     root_sector_info newRootInfo;
@@ -172,7 +213,10 @@ BOOST_FIXTURE_TEST_CASE(new_sector_tree_has_node_with_zero_bytes,
                         sector_tree_mt_dependencies)
 {
     // given
-    auto createrx = tree_type::create_new(*device, fileCryptoContext, *device);
+    auto createrx = tree_type::create_new(*device, fileCryptoContext,
+                                          tree_type::default_cache_size,
+                                          cache_policy::least_recently_used,
+                                          *device);
     TEST_RESULT_REQUIRE(createrx);
     auto tree = std::move(createrx).assume_value();
     TEST_RESULT_REQUIRE(tree->commit([](root_sector_info) {}));
@@ -207,7 +251,10 @@ BOOST_AUTO_TEST_CASE(open_existing_tree_creates_existing_tree)
 
     // when
     auto openrx = tree_type::open_existing(*device, fileCryptoContext,
-                                           rootSectorInfo, *device);
+                                           rootSectorInfo,
+                                           tree_type::default_cache_size,
+                                           cache_policy::least_recently_used,
+                                           *device);
     TEST_RESULT_REQUIRE(openrx);
     auto createdTree = std::move(openrx).assume_value();
 
@@ -391,4 +438,95 @@ BOOST_AUTO_TEST_CASE(increasing_tree_height_doesnt_deadlock)
     TEST_RESULT_REQUIRE(existingTree->commit([](root_sector_info) {}));
 }
 
+BOOST_FIXTURE_TEST_CASE(commit_synchronizes_every_dirty_sector_of_its_tree,
+                        sector_tree_mt_dependencies)
+{
+    auto const cache = tree_type::create_cache(
+                               tree_type::default_cache_size,
+                               cache_policy::least_recently_used)
+                               .value();
+    auto const tree = tree_type::create_new(*device, fileCryptoContext,
+                                            *cache, *device)
+                              .value();
+
+    // the far leaf grows the tree, i.e. the commit spans several layers
+    for (auto const position : {tree_position(0), tree_position(1023)})
+    {
+        write_handle leaf
+                = tree->access_or_create(position).value().as_writable();
+        fill_blob(as_span(leaf), std::byte{0x5a});
+    }
+    TEST_RESULT_REQUIRE(tree->commit([](root_sector_info) {}));
+
+    auto const anyDirty = cache->sync_all();
+    TEST_RESULT_REQUIRE(anyDirty);
+    BOOST_TEST(!anyDirty.assume_value());
+}
+
+BOOST_FIXTURE_TEST_CASE(commit_leaves_the_sectors_of_other_trees_dirty,
+                        sector_tree_mt_dependencies)
+{
+    auto const cache = tree_type::create_cache(
+                               tree_type::default_cache_size,
+                               cache_policy::least_recently_used)
+                               .value();
+    auto const first = tree_type::create_new(*device, fileCryptoContext,
+                                             *cache, *device)
+                               .value();
+    auto const second = tree_type::create_new(*device, fileCryptoContext,
+                                              *cache, *device)
+                                .value();
+    TEST_RESULT_REQUIRE(first->commit([](root_sector_info) {}));
+    TEST_RESULT_REQUIRE(second->commit([](root_sector_info) {}));
+
+    {
+        write_handle leaf
+                = second->access(tree_position(0)).value().as_writable();
+        fill_blob(as_span(leaf), std::byte{0xa5});
+    }
+    TEST_RESULT_REQUIRE(first->commit([](root_sector_info) {}));
+
+    auto const anyDirty = cache->sync_all();
+    TEST_RESULT_REQUIRE(anyDirty);
+    BOOST_TEST(anyDirty.assume_value());
+}
+
+BOOST_AUTO_TEST_CASE(extract_runs_the_loads_no_worker_has_started)
+{
+    constexpr std::uint64_t numLeaves = 3U;
+    for (std::uint64_t i = 0U; i < numLeaves; ++i)
+    {
+        write_handle leaf = existingTree->access_or_create(tree_position{i})
+                                    .value()
+                                    .as_writable();
+        fill_blob(as_span(leaf), static_cast<std::byte>(0x10 + i));
+    }
+    auto const extent = numLeaves * sector_device::sector_payload_size;
+
+    // the executor doesn't run anything on its own, i.e. waiting for a
+    // queued load would never return
+    deferred_executor executor;
+    auto targetFile = vefs::llfio::temp_inode().value();
+    TEST_RESULT_REQUIRE(vefs::detail::extract(*existingTree, targetFile, 0U,
+                                              extent, executor));
+    BOOST_TEST(executor.num_queued() == numLeaves);
+    // the revoked loads must not do anything
+    executor.run_all();
+
+    std::vector<std::byte> content(extent);
+    vefs::llfio::file_handle::buffer_type buffers[] = {
+            {content.data(), content.size()}
+    };
+    (void)targetFile.read({buffers, 0U}).value();
+    for (std::uint64_t i = 0U; i < numLeaves; ++i)
+    {
+        auto const chunk = std::span(content).subspan(
+                i * sector_device::sector_payload_size,
+                sector_device::sector_payload_size);
+        BOOST_TEST(std::ranges::all_of(chunk, [i](std::byte v) {
+            return v == static_cast<std::byte>(0x10 + i);
+        }));
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
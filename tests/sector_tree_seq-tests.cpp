@@ -232,4 +232,29 @@ BOOST_AUTO_TEST_CASE(shrink_on_commit_if_possible)
     BOOST_TEST(newRootInfo.tree_depth == 0);
 }
 
+BOOST_AUTO_TEST_CASE(erase_leaves_erases_in_batches_and_shrinks)
+{
+    // more leaves than fit into a single erase batch
+    constexpr std::uint64_t lastLeaf = sector_device::max_vectored_sectors + 4;
+    for (std::uint64_t i = 0U; i <= lastLeaf; ++i)
+    {
+        TEST_RESULT_REQUIRE(
+                testTree->move_to(i, tree_type::access_mode::create));
+        testTree->writeable_bytes()[0] = std::byte{0x11};
+    }
+    TEST_RESULT_REQUIRE(testTree->commit(
+            [this](root_sector_info cri) { rootSectorInfo = cri; }));
+    BOOST_TEST_REQUIRE(rootSectorInfo.tree_depth == 1);
+
+    TEST_RESULT_REQUIRE(testTree->erase_leaves(lastLeaf));
+
+    root_sector_info newRootInfo;
+    TEST_RESULT_REQUIRE(testTree->commit(
+            [&newRootInfo](root_sector_info cri) { newRootInfo = cri; }));
+    BOOST_TEST(newRootInfo.tree_depth == 0);
+
+    TEST_RESULT_REQUIRE(testTree->move_to(0U));
+    BOOST_TEST(testTree->bytes()[0] == std::byte{0x11});
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1,6 +1,13 @@
 #include "vefs/cache/cache_mt.hpp"
 
+#include <algorithm>
+#include <chrono>
+#include <span>
+#include <thread>
+#include <vector>
+
 #include <boost/predef/compiler.h>
+#include <vefs/cache/clock_policy.hpp>
 #include <vefs/cache/lru_policy.hpp>
 #include <vefs/utils/workaround.h>
 
@@ -49,8 +56,9 @@ struct immovable_value_type
 
 struct ex_stats
 {
-    int syncCalled{0};
-    int purgeCalled{0};
+    std::atomic<int> syncCalled{0};
+    std::atomic<int> purgeCalled{0};
+    std::atomic<int> batchCalled{0};
 };
 
 struct ex_traits
@@ -104,9 +112,91 @@ struct ex_traits
 };
 static_assert(vefs::detail::cache_traits<ex_traits>);
 
+struct clock_traits : ex_traits
+{
+    using eviction = vefs::detail::
+            clock_policy<key_type, std::uint32_t, allocator_type>;
+
+    using ex_traits::ex_traits;
+};
+static_assert(vefs::detail::cache_traits<clock_traits>);
+
+struct teardown_probe : ex_stats
+{
+    std::atomic<bool> syncStarted{false};
+    std::atomic<bool> ownerDiscarded{false};
+    std::atomic<bool> syncedAfterDiscard{false};
+};
+
+//! models a shared cache whose keys below teardown_keys belong to a tree
+//! which is destroyed while its page #0 is evicted
+struct teardown_traits : ex_traits
+{
+    static constexpr key_type teardown_keys = 64U;
+
+    using ex_traits::ex_traits;
+
+    auto sync(key_type key, value_type const &value) noexcept
+            -> vefs::result<void>
+    {
+        auto *const probe = static_cast<teardown_probe *>(stats);
+        if (key == 0U)
+        {
+            probe->syncStarted.store(true);
+            // widens the window in which the owner is torn down
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            if (probe->ownerDiscarded.load())
+            {
+                probe->syncedAfterDiscard.store(true);
+            }
+        }
+        return ex_traits::sync(key, value);
+    }
+};
+static_assert(vefs::detail::cache_traits<teardown_traits>);
+
+struct batch_traits : ex_traits
+{
+    static constexpr std::size_t max_batch_size = 4U;
+
+    using ex_traits::ex_traits;
+
+    auto load_many(load_context const &ctx,
+                   std::span<key_type const> keys,
+                   std::span<vefs::utils::object_storage<value_type> *const>
+                           storages) noexcept -> vefs::result<void>
+    {
+        if (stats != nullptr)
+        {
+            stats->batchCalled += 1;
+        }
+        for (std::size_t i = 0U; i < keys.size(); ++i)
+        {
+            storages[i]->construct(ctx.emplace + static_cast<int>(keys[i]),
+                                   ctx.destructorCalled);
+        }
+        return vefs::success();
+    }
+    auto sync_many(std::span<key_type const> keys,
+                   std::span<value_type *const>) noexcept
+            -> vefs::result<void>
+    {
+        if (stats != nullptr)
+        {
+            stats->batchCalled += 1;
+            stats->syncCalled += static_cast<int>(keys.size());
+        }
+        return vefs::success();
+    }
+};
+static_assert(vefs::detail::cache_batch_load_traits<batch_traits>);
+static_assert(vefs::detail::cache_batch_sync_traits<batch_traits>);
+
 } // namespace vefs_tests
 
 template class vefs::detail::cache_mt<vefs_tests::ex_traits>;
+template class vefs::detail::cache_mt<vefs_tests::batch_traits>;
+template class vefs::detail::cache_mt<vefs_tests::teardown_traits>;
 
 template class vefs::detail::cache_handle<uint64_t, uint32_t>;
 #if VEFS_WORKAROUND_TESTED_AT(BOOST_COMP_CLANG, 16, 0, 6)
@@ -154,6 +244,21 @@ BOOST_AUTO_TEST_CASE(load_simple)
     BOOST_TEST(loadedValue == beef);
 }
 
+BOOST_AUTO_TEST_CASE(stats_count_hits_and_misses)
+{
+    constexpr std::uint32_t key = 1U;
+    constexpr int beef = 0xbeef;
+    cache_mt<ex_traits> subject(1024U, nullptr);
+
+    TEST_RESULT_REQUIRE(subject.pin_or_load({beef, nullptr}, key));
+    TEST_RESULT_REQUIRE(subject.pin_or_load({beef, nullptr}, key));
+
+    auto const stats = subject.stats();
+    BOOST_TEST(stats.misses == 1U);
+    BOOST_TEST(stats.hits == 1U);
+    BOOST_TEST(stats.dirty_evictions == 0U);
+}
+
 BOOST_AUTO_TEST_CASE(upgrade_handle)
 {
     constexpr std::uint32_t key = 1U;
@@ -223,6 +328,241 @@ BOOST_AUTO_TEST_CASE(auto_sync_on_dirty_eviction)
                                     static_cast<unsigned>(max_entries)));
 
     BOOST_TEST(stats.syncCalled == 1);
+    BOOST_TEST(subject.stats().dirty_evictions == 1U);
+}
+
+BOOST_AUTO_TEST_CASE(write_back_syncs_dirty_eviction_candidates)
+{
+    int const max_entries = 64;
+    ex_stats stats{};
+    cache_mt<ex_traits> subject(
+            max_entries + std::thread::hardware_concurrency() * 2, &stats);
+
+    // mark LRU entry as dirty
+    (void)subject.pin_or_load({0, nullptr}, 0U).value().as_writable();
+    // fill cache
+    for (int i = 1; i < max_entries; ++i)
+    {
+        TEST_RESULT_REQUIRE(
+                subject.pin_or_load({i, nullptr}, static_cast<unsigned>(i)));
+    }
+
+    auto const writeBackRx = subject.write_back();
+    TEST_RESULT_REQUIRE(writeBackRx);
+    BOOST_TEST(writeBackRx.assume_value() == 1U);
+    BOOST_TEST(stats.syncCalled == 1);
+
+    // the eviction of #0 doesn't need to sync it again
+    TEST_RESULT(subject.pin_or_load({max_entries, nullptr},
+                                    static_cast<unsigned>(max_entries)));
+
+    BOOST_TEST(stats.syncCalled == 1);
+}
+
+BOOST_AUTO_TEST_CASE(write_back_is_limited_to_the_eviction_window)
+{
+    int const max_entries = 256;
+    ex_stats stats{};
+    cache_mt<ex_traits> subject(
+            max_entries + std::thread::hardware_concurrency() * 2, &stats);
+
+    for (int i = 0; i < max_entries; ++i)
+    {
+        (void)subject.pin_or_load({i, nullptr}, static_cast<unsigned>(i))
+                .value()
+                .as_writable();
+    }
+
+    auto const writeBackRx = subject.write_back();
+    TEST_RESULT_REQUIRE(writeBackRx);
+    BOOST_TEST(writeBackRx.assume_value() == 64U);
+    BOOST_TEST(stats.syncCalled == 64);
+}
+
+BOOST_AUTO_TEST_CASE(dirty_eviction_schedules_a_background_write_back)
+{
+    int const max_entries = 64;
+    ex_stats stats{};
+    std::uint64_t numDirtyEvictions = 0U;
+    {
+        cache_mt<ex_traits> subject(
+                max_entries + std::thread::hardware_concurrency() * 2, &stats,
+                &thread_pool::shared());
+
+        for (int i = 0; i < max_entries; ++i)
+        {
+            (void)subject.pin_or_load({i, nullptr}, static_cast<unsigned>(i))
+                    .value()
+                    .as_writable();
+        }
+        // every eviction candidate is dirty, i.e. the write-back is due
+        TEST_RESULT_REQUIRE(subject.pin_or_load(
+                {max_entries, nullptr}, static_cast<unsigned>(max_entries)));
+        numDirtyEvictions = subject.stats().dirty_evictions;
+    } // the destructor waits for the scheduled write-back
+
+    BOOST_TEST(numDirtyEvictions == 1U);
+    BOOST_TEST(stats.syncCalled == max_entries);
+}
+
+BOOST_AUTO_TEST_CASE(sync_all_syncs_every_dirty_page_concurrently)
+{
+    int const max_entries = 256;
+    ex_stats stats{};
+    cache_mt<ex_traits> subject(
+            max_entries + std::thread::hardware_concurrency() * 2, &stats,
+            &thread_pool::shared());
+
+    for (int i = 0; i < max_entries; ++i)
+    {
+        (void)subject.pin_or_load({i, nullptr}, static_cast<unsigned>(i))
+                .value()
+                .as_writable();
+    }
+
+    auto const syncRx = subject.sync_all();
+    TEST_RESULT_REQUIRE(syncRx);
+    BOOST_TEST(syncRx.assume_value());
+    BOOST_TEST(stats.syncCalled == max_entries);
+
+    auto const resyncRx = subject.sync_all();
+    TEST_RESULT_REQUIRE(resyncRx);
+    BOOST_TEST(!resyncRx.assume_value());
+    BOOST_TEST(stats.syncCalled == max_entries);
+}
+
+BOOST_AUTO_TEST_CASE(sync_keys_syncs_only_the_given_dirty_pages)
+{
+    int const max_entries = 16;
+    ex_stats stats{};
+    cache_mt<ex_traits> subject(
+            max_entries + std::thread::hardware_concurrency() * 2, &stats);
+
+    for (int i = 0; i < max_entries; ++i)
+    {
+        (void)subject.pin_or_load({i, nullptr}, static_cast<unsigned>(i))
+                .value()
+                .as_writable();
+    }
+
+    // 1000 isn't cached at all
+    std::uint64_t const keys[] = {1U, 3U, 5U, 1000U};
+    auto const syncRx = subject.sync_keys(keys);
+    TEST_RESULT_REQUIRE(syncRx);
+    BOOST_TEST(syncRx.assume_value());
+    BOOST_TEST(stats.syncCalled == 3);
+
+    auto const resyncRx = subject.sync_keys(keys);
+    TEST_RESULT_REQUIRE(resyncRx);
+    BOOST_TEST(!resyncRx.assume_value());
+
+    auto const remainingRx = subject.sync_all();
+    TEST_RESULT_REQUIRE(remainingRx);
+    BOOST_TEST(stats.syncCalled == max_entries);
+}
+
+BOOST_AUTO_TEST_CASE(load_many_loads_the_uncached_keys_at_once)
+{
+    ex_stats stats{};
+    cache_mt<batch_traits> subject(1024U, &stats);
+
+    TEST_RESULT_REQUIRE(subject.pin_or_load({0, nullptr}, 1U));
+
+    std::uint64_t const keys[] = {1U, 2U, 3U};
+    TEST_RESULT_REQUIRE(subject.load_many({0, nullptr}, keys));
+    BOOST_TEST(stats.batchCalled == 1);
+    BOOST_TEST(subject.stats().misses == 3U);
+
+    for (auto const key : keys)
+    {
+        auto const h = subject.try_pin(key);
+        BOOST_TEST_REQUIRE(h != nullptr);
+        BOOST_TEST(h->value == static_cast<int>(key == 1U ? 0U : key));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(sync_all_hands_batches_to_sync_many)
+{
+    int const max_entries = 16;
+    ex_stats stats{};
+    cache_mt<batch_traits> subject(1024U, &stats);
+
+    for (int i = 0; i < max_entries; ++i)
+    {
+        (void)subject.pin_or_load({i, nullptr}, static_cast<unsigned>(i))
+                .value()
+                .as_writable();
+    }
+
+    auto const syncRx = subject.sync_all();
+    TEST_RESULT_REQUIRE(syncRx);
+    BOOST_TEST(syncRx.assume_value());
+    BOOST_TEST(stats.syncCalled == max_entries);
+    BOOST_TEST(stats.batchCalled
+               == max_entries / static_cast<int>(batch_traits::max_batch_size));
+}
+
+BOOST_AUTO_TEST_CASE(discard_if_drops_selected_pages_without_sync)
+{
+    int const max_entries = 16;
+    ex_stats stats{};
+    cache_mt<ex_traits> subject(
+            max_entries + std::thread::hardware_concurrency() * 2, &stats);
+
+    for (int i = 0; i < max_entries; ++i)
+    {
+        (void)subject.pin_or_load({i, nullptr}, static_cast<unsigned>(i))
+                .value()
+                .as_writable();
+    }
+    auto const pinned = subject.try_pin(1U);
+
+    auto const numPinned = subject.discard_if(
+            [](std::uint64_t key) noexcept { return key % 2U == 1U; });
+    BOOST_TEST(numPinned == 1U);
+    BOOST_TEST(stats.syncCalled == 0);
+
+    auto const oddDiscarded = subject.try_pin(3U) == nullptr;
+    BOOST_TEST(oddDiscarded);
+    auto const evenRetained = subject.try_pin(2U) != nullptr;
+    BOOST_TEST(evenRetained);
+}
+
+BOOST_AUTO_TEST_CASE(discard_if_waits_for_a_concurrent_dirty_eviction)
+{
+    constexpr auto max_entries = teardown_traits::teardown_keys;
+    teardown_probe probe{};
+    cache_mt<teardown_traits> subject(
+            max_entries + std::thread::hardware_concurrency() * 2, &probe);
+
+    // mark LRU entry as dirty
+    (void)subject.pin_or_load({0, nullptr}, 0U).value().as_writable();
+    // fill cache
+    for (std::uint64_t i = 1U; i < max_entries; ++i)
+    {
+        TEST_RESULT_REQUIRE(
+                subject.pin_or_load({static_cast<int>(i), nullptr}, i));
+    }
+
+    // a miss of another tree evicts #0
+    std::thread otherTree([&subject] {
+        (void)subject.pin_or_load({static_cast<int>(max_entries), nullptr},
+                                  max_entries);
+    });
+    while (!probe.syncStarted.load())
+    {
+        std::this_thread::yield();
+    }
+
+    // tear down the tree owning #0
+    auto const numPinned = subject.discard_if(
+            [](std::uint64_t key) noexcept { return key < max_entries; });
+    probe.ownerDiscarded.store(true);
+    otherTree.join();
+
+    BOOST_TEST(numPinned == 0U);
+    BOOST_TEST(!probe.syncedAfterDiscard.load());
+    BOOST_TEST(probe.syncCalled == 1);
 }
 
 BOOST_AUTO_TEST_CASE(least_recently_used_entry_gets_evicted)
@@ -252,6 +592,109 @@ BOOST_AUTO_TEST_CASE(least_recently_used_entry_gets_evicted)
     BOOST_TEST(destructorCalled);
 }
 
+BOOST_AUTO_TEST_CASE(clock_grants_referenced_entries_a_second_chance)
+{
+    int const max_entries = 64;
+    cache_mt<clock_traits> subject(
+            max_entries + std::thread::hardware_concurrency() * 2, nullptr);
+
+    for (int i = 0; i < max_entries; ++i)
+    {
+        TEST_RESULT_REQUIRE(subject.pin_or_load({i, nullptr},
+                                                static_cast<unsigned>(i)));
+    }
+    // the hit only sets the reference bit of the first inserted entry
+    (void)subject.try_pin(0U);
+    BOOST_TEST(subject.stats().access_record_drops == 0U);
+
+    TEST_RESULT_REQUIRE(subject.pin_or_load(
+            {max_entries, nullptr}, static_cast<unsigned>(max_entries)));
+
+    auto const firstInsertedStillExists = subject.try_pin(0U) != nullptr;
+    BOOST_TEST(firstInsertedStillExists);
+
+    auto const secondInsertedHasBeenPurged = subject.try_pin(1U) == nullptr;
+    BOOST_TEST(secondInsertedHasBeenPurged);
+    BOOST_TEST(subject.stats().hits == 2U);
+}
+
+BOOST_AUTO_TEST_CASE(clock_evicts_while_other_threads_keep_hitting)
+{
+    int const num_hitters = 4;
+    int const max_entries = 64;
+    int const num_misses = 1024;
+    cache_mt<clock_traits> subject(
+            max_entries + std::thread::hardware_concurrency() * 2, nullptr);
+
+    std::atomic<int> numLoaded{0};
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> hitters;
+    for (int t = 0; t < num_hitters; ++t)
+    {
+        hitters.emplace_back([&subject, &numLoaded, &stop] {
+            while (!stop.load(std::memory_order::relaxed))
+            {
+                // reference the recently loaded pages over and over again
+                auto const newest = numLoaded.load(std::memory_order::relaxed);
+                for (int i = std::max(0, newest - max_entries); i < newest;
+                     ++i)
+                {
+                    (void)subject.try_pin(static_cast<unsigned>(i));
+                }
+            }
+        });
+    }
+
+    int numFailures = 0;
+    for (int i = 0; i < num_misses; ++i)
+    {
+        if (!subject.pin_or_load({i, nullptr}, static_cast<unsigned>(i)))
+        {
+            numFailures += 1;
+        }
+        numLoaded.store(i + 1, std::memory_order::relaxed);
+    }
+    stop.store(true, std::memory_order::relaxed);
+    for (auto &hitter : hitters)
+    {
+        hitter.join();
+    }
+
+    BOOST_TEST(numFailures == 0);
+}
+
+BOOST_AUTO_TEST_CASE(concurrent_misses_never_share_a_page)
+{
+    int const num_threads = 8;
+    int const max_entries = 512;
+    cache_mt<ex_traits> subject(
+            64U + std::thread::hardware_concurrency() * 2, nullptr);
+
+    std::atomic<int> numMismatches{0};
+    std::vector<std::thread> workers;
+    for (int t = 0; t < num_threads; ++t)
+    {
+        workers.emplace_back([&subject, &numMismatches, t] {
+            for (int i = t; i < max_entries; i += num_threads)
+            {
+                auto const loadrx = subject.pin_or_load(
+                        {i, nullptr}, static_cast<unsigned>(i));
+                if (!loadrx || loadrx.assume_value()->value != i)
+                {
+                    numMismatches.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto &worker : workers)
+    {
+        worker.join();
+    }
+
+    BOOST_TEST(numMismatches.load() == 0);
+    BOOST_TEST(subject.stats().misses == static_cast<unsigned>(max_entries));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace vefs_tests
@@ -125,6 +125,25 @@ BOOST_AUTO_TEST_CASE(cancel_replacement)
     BOOST_TEST(subject.is_dead());
 }
 
+BOOST_AUTO_TEST_CASE(replacement_clears_the_reference_bit)
+{
+    test_page_state::state_type gen;
+    test_page_state subject;
+    BOOST_TEST(!subject.is_referenced());
+
+    subject.mark_referenced();
+    BOOST_TEST(subject.is_referenced());
+    BOOST_TEST(subject.clear_referenced());
+    BOOST_TEST(!subject.clear_referenced());
+
+    subject.mark_referenced();
+    BOOST_TEST_REQUIRE(
+            (subject.try_start_replace(gen) == cache_replacement_result::dead));
+    subject.finish_replace(0xacdcU);
+    BOOST_TEST(!subject.is_referenced());
+    subject.release();
+}
+
 BOOST_AUTO_TEST_CASE(can_be_managed_with_intrusive_ptr)
 {
     test_page_state::state_type gen;
@@ -0,0 +1,143 @@
+#include "vefs/cache/clock_policy.hpp"
+
+#include <iterator>
+#include <vector>
+
+#include "vefs/cache/eviction_policy.hpp"
+
+#include "boost-unit-test.hpp"
+
+using namespace vefs::detail;
+
+template class vefs::detail::clock_policy<uint64_t, uint16_t>;
+
+static_assert(eviction_policy<clock_policy<uint64_t, uint16_t>>);
+static_assert(
+        std::regular<clock_policy<uint64_t, uint16_t>::replacement_iterator>);
+
+namespace vefs_tests
+{
+
+namespace clock_policy
+{
+
+using test_key = uint64_t;
+using test_index = uint16_t;
+
+using test_policy = vefs::detail::clock_policy<test_key, test_index>;
+
+using test_pages = std::vector<test_policy::page_state>;
+
+struct fixture
+{
+    test_pages pages;
+    test_policy subject;
+
+    fixture()
+        : pages(64)
+        , subject(pages, pages.size())
+    {
+    }
+};
+
+struct with_elements : fixture
+{
+    with_elements()
+        : fixture()
+    {
+        test_policy::page_state::state_type gen;
+        for (std::uint16_t i = 0U; i < 4; ++i)
+        {
+            (void)pages[i].try_start_replace(gen);
+            pages[i].finish_replace(i);
+            pages[i].release();
+            subject.insert(i, i);
+        }
+    }
+};
+
+} // namespace clock_policy
+
+BOOST_FIXTURE_TEST_SUITE(clock_policy, clock_policy::fixture)
+
+BOOST_AUTO_TEST_CASE(ctor_with_pages)
+{
+    BOOST_TEST(subject.num_managed() == 0U);
+    BOOST_TEST(!needs_access_replay(subject));
+    BOOST_TEST((subject.begin() == subject.end()));
+}
+
+BOOST_FIXTURE_TEST_CASE(hand_visits_every_page_twice, with_elements)
+{
+    BOOST_TEST(subject.num_managed() == 4U);
+    BOOST_TEST(std::distance(subject.begin(), subject.end()) == 8);
+    BOOST_TEST(subject.begin()->key() == 0U);
+    BOOST_TEST(std::next(subject.begin(), 4)->key() == 0U);
+}
+
+BOOST_FIXTURE_TEST_CASE(referenced_page_gets_a_second_chance, with_elements)
+{
+    BOOST_TEST(subject.on_access(0U, 0U));
+    BOOST_TEST(pages[0].is_referenced());
+
+    test_index where{};
+    test_policy::page_state::state_type gen;
+    auto it = subject.begin();
+    BOOST_TEST((subject.try_evict(std::move(it), where, gen)
+                == cache_replacement_result::pinned));
+    BOOST_TEST(!pages[0].is_referenced());
+
+    it = std::next(subject.begin());
+    BOOST_TEST((subject.try_evict(std::move(it), where, gen)
+                == cache_replacement_result::clean));
+    BOOST_TEST(where == 1U);
+    BOOST_TEST(subject.num_managed() == 3U);
+    pages[1].cancel_replace();
+
+    // the hand passed the page which got a second chance
+    BOOST_TEST(subject.begin()->key() == 2U);
+}
+
+BOOST_FIXTURE_TEST_CASE(second_pass_ignores_rereferenced_pages, with_elements)
+{
+    test_index where{};
+    test_policy::page_state::state_type gen;
+
+    auto it = subject.begin();
+    for (std::uint16_t i = 0U; i < 4U; ++i, ++it)
+    {
+        pages[i].mark_referenced();
+        auto candidate = it;
+        BOOST_TEST((subject.try_evict(std::move(candidate), where, gen)
+                    == cache_replacement_result::pinned));
+    }
+    // concurrent hits reference every page again before the hand returns
+    for (std::uint16_t i = 0U; i < 4U; ++i)
+    {
+        pages[i].mark_referenced();
+    }
+
+    BOOST_TEST((subject.try_evict(std::move(it), where, gen)
+                == cache_replacement_result::clean));
+    BOOST_TEST(where == 0U);
+    pages[0].cancel_replace();
+}
+
+BOOST_FIXTURE_TEST_CASE(insert_places_the_page_behind_the_hand, with_elements)
+{
+    BOOST_TEST(subject.on_purge(0U, 0U));
+    BOOST_TEST(!subject.on_purge(0U, 0U));
+
+    test_policy::page_state::state_type gen;
+    (void)pages[32].try_start_replace(gen);
+    pages[32].finish_replace(32U);
+    pages[32].release();
+    subject.insert(32U, 32U);
+
+    BOOST_TEST(subject.begin()->key() == 1U);
+    BOOST_TEST(std::next(subject.begin(), 3)->key() == 32U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace vefs_tests
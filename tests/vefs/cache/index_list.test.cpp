@@ -0,0 +1,85 @@
+#include "vefs/cache/index_list.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include "boost-unit-test.hpp"
+
+template class vefs::detail::index_list<std::uint16_t>;
+
+namespace vefs_tests
+{
+
+namespace index_list
+{
+
+using test_list = vefs::detail::index_list<std::uint16_t>;
+
+auto to_vector(test_list const &list) -> std::vector<std::uint16_t>
+{
+    std::vector<std::uint16_t> indices;
+    for (auto it = list.front(); it != list.sentinel(); it = list.next(it))
+    {
+        indices.push_back(it);
+    }
+    return indices;
+}
+
+} // namespace index_list
+
+BOOST_AUTO_TEST_SUITE(index_list)
+
+BOOST_AUTO_TEST_CASE(ctor_creates_an_empty_list)
+{
+    index_list::test_list subject(8U);
+
+    BOOST_TEST(subject.empty());
+    BOOST_TEST(subject.num_indices() == 8U);
+    BOOST_TEST(subject.front() == subject.sentinel());
+    for (std::uint16_t i = 0U; i < 8U; ++i)
+    {
+        BOOST_TEST(!subject.contains(i));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(push_back_appends)
+{
+    index_list::test_list subject(8U);
+    subject.push_back(3U);
+    subject.push_back(0U);
+    subject.push_back(7U);
+
+    BOOST_TEST(subject.size() == 3U);
+    BOOST_TEST(subject.contains(7U));
+    BOOST_TEST(index_list::to_vector(subject)
+                       == (std::vector<std::uint16_t>{3U, 0U, 7U}),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(insert_before_erase_and_move_to_back)
+{
+    index_list::test_list subject(8U);
+    subject.push_back(1U);
+    subject.push_back(2U);
+    subject.insert_before(2U, 5U);
+    BOOST_TEST(index_list::to_vector(subject)
+                       == (std::vector<std::uint16_t>{1U, 5U, 2U}),
+               boost::test_tools::per_element{});
+
+    subject.move_to_back(1U);
+    BOOST_TEST(index_list::to_vector(subject)
+                       == (std::vector<std::uint16_t>{5U, 2U, 1U}),
+               boost::test_tools::per_element{});
+
+    subject.erase(2U);
+    BOOST_TEST(!subject.contains(2U));
+    BOOST_TEST(subject.size() == 2U);
+    BOOST_TEST(subject.prev(1U) == 5U);
+    BOOST_TEST(index_list::to_vector(subject)
+                       == (std::vector<std::uint16_t>{5U, 1U}),
+               boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace vefs_tests
@@ -0,0 +1,163 @@
+#include "vefs/cache/sharded_cache_mt.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+#include <vefs/cache/lru_policy.hpp>
+
+#include "boost-unit-test.hpp"
+#include "test-utils.hpp"
+
+namespace vefs_tests
+{
+
+namespace sharded_cache_mt
+{
+
+struct sync_log
+{
+    std::mutex sync;
+    std::vector<std::uint64_t> syncedKeys;
+};
+
+struct traits
+{
+    using initializer_type = sync_log *;
+    using key_type = std::uint64_t;
+    using value_type = int;
+    struct load_context
+    {
+        int emplace;
+    };
+    struct purge_context
+    {
+    };
+    using allocator_type = std::allocator<void>;
+    using eviction = vefs::detail::
+            least_recently_used_policy<key_type, std::uint32_t, allocator_type>;
+
+    sync_log *log;
+    traits(sync_log *l)
+        : log(l)
+    {
+    }
+
+    auto load(load_context const &ctx,
+              key_type,
+              vefs::utils::object_storage<value_type> &storage) noexcept
+            -> vefs::result<std::pair<value_type *, bool>>
+    {
+        return std::pair{&storage.construct(ctx.emplace), false};
+    }
+    auto sync(key_type key, value_type const &) noexcept -> vefs::result<void>
+    {
+        if (log != nullptr)
+        {
+            std::lock_guard lock{log->sync};
+            log->syncedKeys.push_back(key);
+        }
+        return vefs::success();
+    }
+    auto purge(purge_context const &, key_type, value_type &) noexcept
+            -> vefs::result<void>
+    {
+        return vefs::success();
+    }
+};
+static_assert(vefs::detail::cache_traits<traits>);
+
+using test_cache = vefs::detail::sharded_cache_mt<traits>;
+
+} // namespace sharded_cache_mt
+
+} // namespace vefs_tests
+
+template class vefs::detail::sharded_cache_mt<
+        vefs_tests::sharded_cache_mt::traits>;
+
+namespace vefs_tests
+{
+
+BOOST_AUTO_TEST_SUITE(sharded_cache_mt)
+
+BOOST_AUTO_TEST_CASE(ctor_splits_the_pages_between_the_shards)
+{
+    sharded_cache_mt::test_cache subject(4099U, 4U, nullptr);
+
+    BOOST_TEST(subject.num_shards() == 4U);
+    BOOST_TEST(subject.size() == 4099U);
+}
+
+BOOST_AUTO_TEST_CASE(small_caches_are_not_sharded)
+{
+    BOOST_TEST(sharded_cache_mt::test_cache::suggested_num_shards(0U) == 1U);
+    BOOST_TEST(sharded_cache_mt::test_cache::suggested_num_shards(
+                       sharded_cache_mt::test_cache::min_shard_size * 2 - 1)
+               == 1U);
+}
+
+BOOST_AUTO_TEST_CASE(stats_accumulate_over_all_shards)
+{
+    int const max_entries = 256;
+    sharded_cache_mt::test_cache subject(4096U, 4U, nullptr);
+
+    for (int i = 0; i < max_entries; ++i)
+    {
+        TEST_RESULT_REQUIRE(
+                subject.pin_or_load({i}, static_cast<unsigned>(i)));
+    }
+    for (int i = 0; i < max_entries; ++i)
+    {
+        auto const h = subject.try_pin(static_cast<unsigned>(i));
+        BOOST_TEST_REQUIRE(h != nullptr);
+        BOOST_TEST(*h == i);
+    }
+
+    auto const stats = subject.stats();
+    BOOST_TEST(stats.misses == static_cast<unsigned>(max_entries));
+    BOOST_TEST(stats.hits == static_cast<unsigned>(max_entries));
+}
+
+BOOST_AUTO_TEST_CASE(purge_by_handle_selects_the_owning_shard)
+{
+    sharded_cache_mt::test_cache subject(4096U, 4U, nullptr);
+
+    auto loadrx = subject.pin_or_load({1}, 7U);
+    TEST_RESULT_REQUIRE(loadrx);
+
+    sharded_cache_mt::traits::purge_context purgeContext;
+    TEST_RESULT_REQUIRE(
+            subject.purge(purgeContext, std::move(loadrx).assume_value()));
+    BOOST_TEST(subject.try_pin(7U) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(sync_all_preserves_the_rank_order_across_shards)
+{
+    int const max_entries = 256;
+    sharded_cache_mt::sync_log log;
+    sharded_cache_mt::test_cache subject(4096U, 4U, &log);
+
+    for (int i = 0; i < max_entries; ++i)
+    {
+        (void)subject.pin_or_load({i}, static_cast<unsigned>(i))
+                .value()
+                .as_writable();
+    }
+
+    auto const rankOf = [](std::uint64_t key) noexcept { return key % 4U; };
+    auto const syncRx = subject.sync_all(rankOf);
+    TEST_RESULT_REQUIRE(syncRx);
+    BOOST_TEST(syncRx.assume_value());
+
+    BOOST_TEST(log.syncedKeys.size() == static_cast<unsigned>(max_entries));
+    BOOST_TEST(std::ranges::is_sorted(log.syncedKeys, {}, rankOf));
+
+    auto const resyncRx = subject.sync_all(rankOf);
+    TEST_RESULT_REQUIRE(resyncRx);
+    BOOST_TEST(!resyncRx.assume_value());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace vefs_tests
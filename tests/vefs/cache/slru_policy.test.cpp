@@ -1,5 +1,9 @@
 #include "vefs/cache/slru_policy.hpp"
 
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
 #include "vefs/cache/eviction_policy.hpp"
 
 #include "boost-unit-test.hpp"
@@ -124,6 +128,30 @@ BOOST_FIXTURE_TEST_CASE(newly_inserted_are_due_before_protected, with_elements)
             == 1);
 }
 
+BOOST_FIXTURE_TEST_CASE(purge_keeps_the_segment_boundary, with_elements)
+{
+    test_key protectedKey = 0U;
+    test_key newElementKey = 0xdead'beef;
+    test_index newElementIndex = 32U;
+    BOOST_TEST(subject.on_access(protectedKey, 0U));
+    BOOST_TEST(subject.on_purge(1U, 1U));
+    BOOST_TEST(!subject.on_purge(1U, 1U));
+    {
+        test_policy::page_state::state_type gen;
+        (void)pages[newElementIndex].try_start_replace(gen);
+        pages[newElementIndex].finish_replace(newElementKey);
+        pages[newElementIndex].release();
+        subject.insert(newElementKey, newElementIndex);
+    }
+
+    BOOST_TEST(subject.num_managed() == 4U);
+    std::vector<test_key> keys;
+    std::ranges::transform(subject.begin(), subject.end(),
+                           std::back_inserter(keys), get_page_key{});
+    BOOST_TEST(keys == (std::vector<test_key>{2U, 3U, newElementKey, 0U}),
+               boost::test_tools::per_element{});
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 } // namespace vefs_tests
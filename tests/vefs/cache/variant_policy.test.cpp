@@ -0,0 +1,95 @@
+#include "vefs/cache/variant_policy.hpp"
+
+#include "vefs/cache/eviction_policy.hpp"
+#include "vefs/cache/lru_policy.hpp"
+#include "vefs/cache/slru_policy.hpp"
+
+#include "boost-unit-test.hpp"
+
+using namespace vefs::detail;
+
+using lru_slru_policy = vefs::detail::variant_policy<
+        least_recently_used_policy<uint64_t, uint16_t>,
+        segmented_least_recently_used_policy<uint64_t, uint16_t>>;
+
+template class vefs::detail::variant_policy<
+        least_recently_used_policy<uint64_t, uint16_t>,
+        segmented_least_recently_used_policy<uint64_t, uint16_t>>;
+
+static_assert(eviction_policy<lru_slru_policy>);
+static_assert(std::regular<lru_slru_policy::replacement_iterator>);
+
+namespace vefs_tests
+{
+
+namespace variant_policy
+{
+
+using test_key = uint64_t;
+using test_index = uint16_t;
+
+using test_policy = lru_slru_policy;
+
+using test_pages = std::vector<test_policy::page_state>;
+
+struct fixture
+{
+    test_pages pages;
+    test_policy subject;
+
+    fixture()
+        : pages(64)
+        , subject(pages, pages.size(), std::allocator<void>(), 1U)
+    {
+    }
+};
+
+struct with_elements : fixture
+{
+    with_elements()
+        : fixture()
+    {
+        test_policy::page_state::state_type gen;
+        for (std::uint16_t i = 0U; i < 4; ++i)
+        {
+            (void)pages[i].try_start_replace(gen);
+            pages[i].finish_replace(i);
+            pages[i].release();
+            subject.insert(i, i);
+        }
+    }
+};
+
+} // namespace variant_policy
+
+BOOST_FIXTURE_TEST_SUITE(variant_policy, variant_policy::fixture)
+
+BOOST_AUTO_TEST_CASE(ctor_selects_policy)
+{
+    BOOST_TEST(subject.selected() == 1U);
+    BOOST_TEST(subject.num_managed() == 0U);
+}
+
+BOOST_AUTO_TEST_CASE(ctor_falls_back_to_first_policy)
+{
+    variant_policy::test_policy fallback(pages, pages.size(),
+                                         std::allocator<void>(), 7U);
+    BOOST_TEST(fallback.selected() == 0U);
+}
+
+BOOST_FIXTURE_TEST_CASE(evicts_through_selected_policy, with_elements)
+{
+    BOOST_TEST(subject.num_managed() == 4U);
+    BOOST_TEST(std::distance(subject.begin(), subject.end()) == 4);
+
+    test_index where{};
+    test_policy::page_state::state_type gen;
+    BOOST_TEST((subject.try_evict(subject.begin(), where, gen)
+                == cache_replacement_result::clean));
+    BOOST_TEST(where == 0U);
+    BOOST_TEST(subject.num_managed() == 3U);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace vefs_tests
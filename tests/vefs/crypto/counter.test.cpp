@@ -0,0 +1,54 @@
+#include "vefs/crypto/counter.hpp"
+
+#include <cstdint>
+
+#include "boost-unit-test.hpp"
+#include "test-utils.hpp"
+
+using namespace vefs;
+
+namespace
+{
+
+auto counter_at(std::uint64_t low, std::uint64_t high) noexcept
+        -> crypto::counter
+{
+    crypto::counter::state state{};
+    auto bytes = as_writable_bytes(as_span(state));
+    for (int i = 0; i < 8; ++i)
+    {
+        bytes[i] = static_cast<std::byte>(low >> (i * 8));
+        bytes[8 + i] = static_cast<std::byte>(high >> (i * 8));
+    }
+    return crypto::counter{state};
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_SUITE(counter_tests)
+
+BOOST_AUTO_TEST_CASE(advance_equals_repeated_increments)
+{
+    auto subject = counter_at(~std::uint64_t{} - 2U, 7U);
+    auto expected = subject;
+    for (int i = 0; i < 5; ++i)
+    {
+        expected.increment();
+    }
+
+    subject.advance(5U);
+    BOOST_TEST((subject == expected));
+    BOOST_TEST((subject == counter_at(2U, 8U)));
+}
+
+BOOST_AUTO_TEST_CASE(sequence_reserves_consecutive_blocks)
+{
+    crypto::counter_sequence subject{counter_at(40U, 0U)};
+
+    BOOST_TEST((subject.reserve() == counter_at(40U, 0U)));
+    BOOST_TEST((subject.reserve(8U) == counter_at(41U, 0U)));
+    BOOST_TEST((subject.reserve() == counter_at(49U, 0U)));
+    BOOST_TEST((subject.load() == counter_at(50U, 0U)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
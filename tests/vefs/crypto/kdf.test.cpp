@@ -0,0 +1,48 @@
+#include "vefs/crypto/kdf.hpp"
+
+#include <array>
+
+#include "boost-unit-test.hpp"
+#include "test-utils.hpp"
+
+using namespace vefs;
+
+BOOST_AUTO_TEST_SUITE(kdf_tests)
+
+BOOST_AUTO_TEST_CASE(keyed_kdf_matches_kdf)
+{
+    auto const inputKey = utils::make_byte_array(
+            0x6a, 0x09, 0xe6, 0x67, 0xf3, 0xbc, 0xc9, 0x08, 0xbb, 0x67, 0xae,
+            0x85, 0x84, 0xca, 0xa7, 0x3b, 0x3c, 0x6e, 0xf3, 0x72, 0xfe, 0x94,
+            0xf8, 0x2b, 0xa5, 0x4f, 0xf5, 0x3a, 0x5f, 0x1d, 0x36, 0xf1);
+    auto const prefix = utils::make_byte_array(0x76, 0x65, 0x66, 0x73);
+    auto const salt = utils::make_byte_array(0x51, 0x0e, 0x52, 0x7f, 0xad,
+                                             0xe6, 0x82, 0xd1, 0x9b, 0x05);
+
+    std::array<std::byte, 44> expected{};
+    TEST_RESULT_REQUIRE(crypto::kdf(expected, inputKey, prefix, salt));
+
+    crypto::keyed_kdf subject;
+    TEST_RESULT_REQUIRE(subject.init(expected.size(), inputKey, prefix));
+
+    // the precomputed state must be reusable
+    for (int i = 0; i < 2; ++i)
+    {
+        std::array<std::byte, 44> derived{};
+        TEST_RESULT_REQUIRE(subject.derive(derived, salt));
+        BOOST_TEST(derived == expected, boost::test_tools::per_element{});
+    }
+}
+
+BOOST_AUTO_TEST_CASE(keyed_kdf_rejects_other_prk_sizes)
+{
+    auto const inputKey = utils::make_byte_array(0x01, 0x02, 0x03, 0x04);
+
+    crypto::keyed_kdf subject;
+    TEST_RESULT_REQUIRE(subject.init(44U, inputKey, inputKey));
+
+    std::array<std::byte, 32> derived{};
+    BOOST_TEST(subject.derive(derived, inputKey).has_error());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
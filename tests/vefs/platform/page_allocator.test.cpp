@@ -0,0 +1,62 @@
+#include "vefs/platform/page_allocator.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "boost-unit-test.hpp"
+
+template class vefs::detail::page_allocator<std::byte>;
+
+namespace vefs_tests
+{
+
+using vefs::detail::page_allocator;
+
+BOOST_AUTO_TEST_SUITE(page_allocator_tests)
+
+BOOST_AUTO_TEST_CASE(default_ctor_has_no_placement)
+{
+    page_allocator<void> subject;
+
+    BOOST_TEST(!subject.huge_pages());
+    BOOST_TEST(subject.numa_node() == vefs::detail::no_numa_node);
+    BOOST_TEST((subject == page_allocator<void>(false, -1)));
+}
+
+BOOST_AUTO_TEST_CASE(for_shard_resolves_interleaving)
+{
+    page_allocator<void> subject(true, vefs::detail::interleave_numa_nodes);
+
+    for (unsigned i = 0U; i < 4U; ++i)
+    {
+        auto const shardAllocator = subject.for_shard(i);
+        BOOST_TEST(shardAllocator.huge_pages());
+        BOOST_TEST(shardAllocator.numa_node() >= 0);
+        BOOST_TEST(static_cast<unsigned>(shardAllocator.numa_node())
+                   < vefs::detail::num_numa_nodes());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(huge_page_mapping_is_writable)
+{
+    auto const size = page_allocator<std::byte>::min_mapping_size * 3 + 17;
+    std::vector<std::byte, page_allocator<std::byte>> storage(
+            size, page_allocator<std::byte>(true, 0));
+
+    std::ranges::fill(storage, std::byte{0xa5});
+    BOOST_TEST((storage.front() == std::byte{0xa5}));
+    BOOST_TEST((storage.back() == std::byte{0xa5}));
+}
+
+BOOST_AUTO_TEST_CASE(small_allocations_are_not_mapped)
+{
+    std::vector<int, page_allocator<int>> storage(
+            16U, page_allocator<int>(true, 0));
+    storage[15] = 0x5a;
+    BOOST_TEST(storage[15] == 0x5a);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+} // namespace vefs_tests
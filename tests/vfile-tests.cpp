@@ -174,4 +174,56 @@ BOOST_AUTO_TEST_CASE(extract_to_file)
                boost::test_tools::per_element{});
 }
 
+BOOST_AUTO_TEST_CASE(sequential_reads_return_written_content)
+{
+    constexpr std::size_t chunkSize = 4096U;
+    constexpr std::size_t fileSize = 12U * sector_device::sector_payload_size;
+    std::vector<std::byte> content(fileSize);
+    for (std::size_t i = 0U; i < content.size(); ++i)
+    {
+        content[i] = static_cast<std::byte>(i % 251U);
+    }
+    TEST_RESULT_REQUIRE(testSubject->write(content, 0));
+    TEST_RESULT_REQUIRE(testSubject->commit());
+
+    std::vector<std::byte> readBack(fileSize);
+    for (std::size_t pos = 0U; pos < fileSize; pos += chunkSize)
+    {
+        auto const readSize = std::min(chunkSize, fileSize - pos);
+        TEST_RESULT_REQUIRE(testSubject->read(
+                rw_dynblob(readBack).subspan(pos, readSize), pos));
+    }
+
+    BOOST_TEST(readBack == content, boost::test_tools::per_element{});
+}
+
+BOOST_AUTO_TEST_CASE(reopened_large_file_gets_a_larger_cache)
+{
+    using file_tree = sector_tree_mt<
+            cow_tree_allocator_mt<archive_sector_allocator>>;
+
+    // a new file starts with the minimum cache size
+    BOOST_TEST(testSubject->cache_size()
+               >= archive_options{}.min_file_cache_size
+                          / sector_device::sector_size);
+    BOOST_TEST(testSubject->cache_size() < file_tree::default_cache_size);
+
+    constexpr std::size_t fileSize = std::size_t{file_tree::default_cache_size}
+                                     * sector_device::sector_payload_size;
+    std::vector<std::byte> const chunk(std::size_t{1} << 20, std::byte{0x5a});
+    for (std::size_t pos = 0U; pos < fileSize; pos += chunk.size())
+    {
+        auto const writeSize = std::min(chunk.size(), fileSize - pos);
+        TEST_RESULT_REQUIRE(
+                testSubject->write(ro_dynblob(chunk).first(writeSize), pos));
+    }
+    TEST_RESULT_REQUIRE(testSubject->commit());
+    testSubject.reset();
+
+    testSubject = fileSystem->open("test-file", file_open_mode::readwrite)
+                          .value();
+    BOOST_TEST(testSubject->maximum_extent() == fileSize);
+    BOOST_TEST(testSubject->cache_size() > file_tree::default_cache_size);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -257,10 +257,13 @@ BOOST_AUTO_TEST_CASE(filesystem_cannot_commit_non_existing_files)
             {0xc7, 0xa5, 0x3d, 0x7a, 0xa4, 0xf0, 0x40, 0x53, 0xa7, 0xa3, 0x35,
              0xf3, 0x5c, 0xdf, 0x53, 0x3d}
     });
-    auto file
-            = vefs::vfile::create_new(testSubject.get(), workExecutor,
-                                      sectorAllocator, fid, *device, *cryptoCtx)
-                      .value();
+    cache_budget cacheBudget(archive_options::default_cache_budget, 0U,
+                             sector_device::sector_size);
+    auto file = vefs::vfile::create_new(testSubject.get(), workExecutor,
+                                        sectorAllocator, cacheBudget, nullptr,
+                                        cache_policy::least_recently_used, fid,
+                                        *device, *cryptoCtx)
+                        .value();
     auto result = file->commit();
 
     BOOST_TEST(!result);
@@ -268,6 +271,44 @@ BOOST_AUTO_TEST_CASE(filesystem_cannot_commit_non_existing_files)
     BOOST_TEST(file->is_dirty());
 }
 
+BOOST_AUTO_TEST_CASE(file_cannot_be_created_with_an_exhausted_cache_budget)
+{
+    file_id const fid(vefs::uuid{
+            {0x3e, 0x51, 0x0b, 0x9f, 0x27, 0xc4, 0x4d, 0x6a, 0x8e, 0x12, 0x75,
+             0xa0, 0x4b, 0xd3, 0x19, 0x6c}
+    });
+    cache_budget cacheBudget(0U, 0U, sector_device::sector_size);
+    auto result = vefs::vfile::create_new(
+            testSubject.get(), workExecutor, sectorAllocator, cacheBudget,
+            nullptr, cache_policy::least_recently_used, fid, *device,
+            *cryptoCtx);
+
+    BOOST_TEST(!result);
+    BOOST_TEST(result.error() == errc::not_enough_memory);
+    BOOST_TEST(cacheBudget.available() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(file_gets_the_minimum_cache_from_an_exhausted_soft_budget)
+{
+    file_id const fid(vefs::uuid{
+            {0x8a, 0x27, 0xd1, 0x4c, 0x60, 0x3b, 0x4f, 0x95, 0xb2, 0x0e, 0xc8,
+             0x71, 0x5d, 0x9a, 0xe4, 0x33}
+    });
+    cache_budget cacheBudget(0U, 0U, sector_device::sector_size, false);
+    auto file = vefs::vfile::create_new(testSubject.get(), workExecutor,
+                                        sectorAllocator, cacheBudget, nullptr,
+                                        cache_policy::least_recently_used, fid,
+                                        *device, *cryptoCtx);
+    TEST_RESULT_REQUIRE(file);
+
+    BOOST_TEST(cacheBudget.available() < 0);
+    BOOST_TEST(file.assume_value()->cache_size()
+               == static_cast<std::size_t>(-cacheBudget.available()));
+
+    file.assume_value().reset();
+    BOOST_TEST(cacheBudget.available() == 0);
+}
+
 BOOST_AUTO_TEST_CASE(file_in_use_cannot_be_erased)
 {
     auto vfilerx = testSubject
@@ -366,4 +407,48 @@ BOOST_AUTO_TEST_CASE(extract_vfile_to_file)
 
     BOOST_TEST(result[0] == writeBlob, boost::test_tools::per_element{});
 }
+
+BOOST_AUTO_TEST_CASE(extract_all_vfiles_to_files)
+{
+    auto basePath = vefs_tests::current_path.current_path().assume_value();
+    std::string const testFileNames[] = {"extract-all-0", "extract-all-1",
+                                         "extract-all-2", "extract-all-3"};
+
+    for (std::size_t i = 0; i < std::size(testFileNames); ++i)
+    {
+        std::filesystem::remove(basePath / testFileNames[i]);
+
+        auto vfilerx = testSubject->open(testFileNames[i],
+                                         file_open_mode::readwrite
+                                                 | file_open_mode::create);
+        TEST_RESULT_REQUIRE(vfilerx);
+        auto file = vfilerx.assume_value();
+        TEST_RESULT_REQUIRE(file->truncate(0x1'0000 * (i + 1)));
+        auto writeBlob = utils::make_byte_array(0x41, 0x42, 0x43,
+                                                static_cast<int>(i));
+        TEST_RESULT_REQUIRE(file->write(writeBlob, 0x1'0000 * i));
+        TEST_RESULT_REQUIRE(file->commit());
+    }
+    TEST_RESULT_REQUIRE(testSubject->commit());
+
+    TEST_RESULT_REQUIRE(testSubject->extractAll(basePath));
+
+    auto basePathHandle = vefs::llfio::path(basePath).assume_value();
+    for (std::size_t i = 0; i < std::size(testFileNames); ++i)
+    {
+        auto fileHandle
+                = vefs::llfio::file(basePathHandle, testFileNames[i],
+                                    vefs::llfio::file_handle::mode::read)
+                          .assume_value();
+        BOOST_TEST(fileHandle.maximum_extent().value() == 0x1'0000 * (i + 1));
+
+        std::byte array[4];
+        llfio::byte_io_handle::buffer_type outBuffers[] = {{array}};
+        auto result = fileHandle.read({outBuffers, 0x1'0000 * i}).value();
+
+        auto expected = utils::make_byte_array(0x41, 0x42, 0x43,
+                                               static_cast<int>(i));
+        BOOST_TEST(result[0] == expected, boost::test_tools::per_element{});
+    }
+}
 BOOST_AUTO_TEST_SUITE_END()